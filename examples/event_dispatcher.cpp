@@ -1,12 +1,26 @@
 #include <events/dispatcher/event_dispatcher.hpp>
+#include <events/dispatcher/static_event_dispatcher.hpp>
+#include <events/frame_arena.hpp>
 
 #include <iostream>
+#include <memory_resource>
+#include <string>
 
 
 struct contrived_event {
 	int value;
 };
 
+struct message_event {
+	std::pmr::string text;
+};
+
+struct contrived_listener {
+	auto on_event(contrived_event const& event) -> void {
+		std::cout << "Listener received an event: " << event.value << '\n';
+	}
+};
+
 
 auto main() -> int {
 	auto dispatcher = events::event_dispatcher{};
@@ -17,6 +31,11 @@ auto main() -> int {
 		std::cout << "Received an event: " << event.value << '\n';
 	});
 
+	// Member functions can be connected directly. The event type is deduced from the function's parameter, and only
+	// the object pointer is stored.
+	auto listener = contrived_listener{};
+	events::scoped_connection member_connection = dispatcher.connect<&contrived_listener::on_event>(&listener);
+
 	// Events can be enqueued for later dispatch
 	dispatcher.enqueue(contrived_event{0});
 	dispatcher.enqueue<contrived_event>(1);
@@ -27,5 +46,26 @@ auto main() -> int {
 	// dispatch() will send all enqueued events
 	dispatcher.dispatch();
 
+
+	// If the set of event types is known up front, a static_event_dispatcher resolves each event type at compile time
+	auto static_dispatcher = events::static_event_dispatcher<contrived_event>{};
+
+	static_dispatcher.connect<&contrived_listener::on_event>(&listener);
+	static_dispatcher.enqueue(contrived_event{3});
+	static_dispatcher.dispatch();
+
+
+	// Events that own memory can allocate it from a frame arena. The arena's memory is reused on every dispatch
+	// instead of being freed one event at a time.
+	auto arena = events::frame_arena{};
+	auto frame_dispatcher = events::event_dispatcher{arena};
+
+	frame_dispatcher.connect<message_event>([](auto const& event) {
+		std::cout << "Received a message: " << event.text << '\n';
+	});
+
+	frame_dispatcher.enqueue(message_event{std::pmr::string{"allocated from the frame arena", &arena}});
+	frame_dispatcher.dispatch();
+
 	return 0;
 }
@@ -1,4 +1,5 @@
 #include <events/signal_handler/signal_handler.hpp>
+#include <events/signal_handler/static_signal.hpp>
 
 #include <iostream>
 
@@ -30,5 +31,37 @@ auto main() -> int {
 
 	auto results = sigh_return.publish(5); //results == [10, 50]
 
+	// Results can also be folded as they are produced, or the first matching result returned, without allocating
+	auto sum = sigh_return.publish_reduce(0, std::plus<>{}, 5);                 //sum == 60
+	auto first = sigh_return.publish_until([](int n) { return n > 20; }, 5); //first == 50
+
+	std::cout << "Sum of results: " << sum << '\n';
+	if (first) {
+		std::cout << "First result over 20: " << *first << '\n';
+	}
+
+
+	// Callbacks are stored in a std::function by default. A small_function stores callbacks inline instead, avoiding
+	// an allocation for any callback that fits in its buffer. The buffer size is configurable.
+	using small_callback = events::small_function<void(int), 64>;
+	auto sigh_small = events::signal_handler<void(int), std::allocator<void>, small_callback>{};
+
+	auto a = 1, b = 2, c = 3, d = 4;
+	sigh_small.connect([a, b, c, d](int n) {
+		std::cout << "Received signal: " << (n + a + b + c + d) << '\n';
+	});
+
+	sigh_small.publish(0);
+
+
+	// A static_signal has a fixed set of listeners known at compile time, which are called directly when publishing
+	using static_sigh = events::static_signal<int(int), [](int n) { return n * 2; }, [](int n) { return n * 10; }>;
+
+	auto static_results = static_sigh::publish(5); //static_results == std::array{10, 50}
+
+	for (auto const result : static_results) {
+		std::cout << "Static signal result: " << result << '\n';
+	}
+
 	return 0;
 }
@@ -1,22 +1,41 @@
 #pragma once
 
-#include <functional>
+#include <cstdint>
+#include <type_traits>
 #include <utility>
 
 
 namespace events {
 
+/**
+ * @brief A handle to a callback registered with a signal handler or event dispatcher, which can be used to disconnect
+ *        it. A connection is trivially copyable, and consists of a pointer to the signal handler, a function pointer
+ *        which disconnects the callback, and a generation-checked key.
+ *
+ * @details Disconnecting a callback that has already been disconnected, through another copy of the connection or by
+ *          disconnecting all callbacks, does nothing. The same goes for a signal handler that has been moved from.
+ *          However, the signal handler itself must still be alive.
+ */
 class connection {
-	template<typename, typename>
+	template<typename, typename, typename, typename>
 	friend class signal_handler;
 
-	template<typename, typename>
+	template<typename, typename, typename>
 	friend class synchronized_signal_handler;
 
 	template<typename, typename, typename>
+	friend class snapshot_signal_handler;
+
+	template<typename, typename, typename, typename>
 	friend class async_signal_handler;
 
-	explicit connection(std::function<void()> function) : disconnect_function(std::move(function)) {
+	using disconnect_type = void (*)(void*, uint32_t, uint32_t);
+
+	connection(void* owner_pointer, disconnect_type function, uint32_t key_index, uint32_t key_generation) noexcept :
+		owner(owner_pointer),
+		disconnect_function(function),
+		index(key_index),
+		generation(key_generation) {
 	}
 
 public:
@@ -30,26 +49,32 @@ public:
 	auto operator=(connection&&) noexcept -> connection& = default;
 
 	[[nodiscard]] explicit operator bool() const noexcept {
-		return static_cast<bool>(disconnect_function);
+		return owner != nullptr;
 	}
 
 	auto disconnect() -> void {
-		if (disconnect_function) {
-			disconnect_function();
-			disconnect_function = nullptr;
+		if (owner) {
+			disconnect_function(owner, index, generation);
+			owner = nullptr;
 		}
 	}
 
 private:
-	std::function<void()> disconnect_function;
+	void* owner = nullptr;
+	disconnect_type disconnect_function = nullptr;
+	uint32_t index = 0;
+	uint32_t generation = 0;
 };
 
+static_assert(std::is_trivially_copyable_v<connection>);
+
 
 class [[nodiscard]] scoped_connection {
 public:
 	scoped_connection() = default;
 	scoped_connection(scoped_connection const&) = delete;
-	scoped_connection(scoped_connection&&) noexcept = default;
+	scoped_connection(scoped_connection&& other) noexcept : connect(std::exchange(other.connect, connection{})) {
+	}
 
 	//NOLINTNEXTLINE(google-explicit-constructor,hicpp-explicit-conversions)
 	scoped_connection(connection other) : connect(std::move(other)) {
@@ -60,7 +85,10 @@ public:
 	}
 
 	auto operator=(scoped_connection const&) -> scoped_connection& = delete;
-	auto operator=(scoped_connection&&) noexcept -> scoped_connection& = default;
+	auto operator=(scoped_connection&& other) noexcept -> scoped_connection& {
+		connect = std::exchange(other.connect, connection{});
+		return *this;
+	}
 
 	auto operator=(connection const& other) -> scoped_connection& {
 		connect = other;
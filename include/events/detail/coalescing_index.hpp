@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+#include <events/detail/dispatcher_table.hpp>
+#include <events/detail/type_id.hpp>
+
+
+namespace events::detail {
+
+/// The default merge function for coalesced events, which replaces the pending event with the newer one
+struct replace_event {
+	template<typename EventT>
+	auto operator()(EventT& pending, EventT&& incoming) const -> void {
+		pending = std::move(incoming);
+	}
+};
+
+
+template<typename KeyT = void, typename AllocatorT = std::allocator<void>>
+class coalescing_index;
+
+
+template<typename AllocatorT>
+class coalescing_index<void, AllocatorT> {
+public:
+	coalescing_index() = default;
+	coalescing_index(coalescing_index const&) = delete;
+	coalescing_index(coalescing_index&&) noexcept = default;
+
+	virtual ~coalescing_index() = default;
+
+	auto operator=(coalescing_index const&) -> coalescing_index& = delete;
+	auto operator=(coalescing_index&&) noexcept -> coalescing_index& = default;
+
+	virtual auto clear() noexcept -> void = 0;
+};
+
+
+/// Maps the keys of coalesced events to the position of the pending event in an event queue
+template<typename KeyT, typename AllocatorT>
+class coalescing_index final : public coalescing_index<void, AllocatorT> {
+	using value_type = std::pair<KeyT const, size_t>;
+	using map_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<value_type>;
+	using map_type = std::unordered_map<KeyT, size_t, std::hash<KeyT>, std::equal_to<KeyT>, map_allocator_type>;
+
+public:
+	explicit coalescing_index(AllocatorT const& alloc) : positions(alloc) {
+	}
+
+	/**
+	 * @brief Find the position of the pending event with a key, or record that the key's event will be at the given
+	 *        position if there isn't one.
+	 *
+	 * @return The position of the event with this key, and whether it was newly recorded
+	 */
+	auto try_emplace(KeyT const& key, size_t position) -> std::pair<size_t, bool> {
+		auto const [iter, inserted] = positions.try_emplace(key, position);
+		return {iter->second, inserted};
+	}
+
+	/// Forget the key of a newly recorded event, if the event couldn't be enqueued
+	auto erase(KeyT const& key) noexcept -> void {
+		positions.erase(key);
+	}
+
+	auto clear() noexcept -> void override {
+		positions.clear();
+	}
+
+private:
+	map_type positions;
+};
+
+
+/**
+ * @brief The coalescing indices of one event queue, one for each key type that has been used with it. Indices are
+ *        looked up by the @ref type_id of their key type.
+ *
+ * @details The indices refer to positions in the queue's pending events, so they must be cleared whenever those
+ *          events are taken for dispatch or discarded.
+ */
+template<typename AllocatorT>
+class coalescing_indices {
+	using generic_index = coalescing_index<void, AllocatorT>;
+
+public:
+	coalescing_indices() : coalescing_indices(AllocatorT{}) {
+	}
+
+	explicit coalescing_indices(AllocatorT const& alloc) : allocator(alloc), indices(alloc) {
+	}
+
+	coalescing_indices(coalescing_indices const&) = delete;
+
+	coalescing_indices(coalescing_indices&&) noexcept = default;
+
+	coalescing_indices(coalescing_indices&& other, AllocatorT const& alloc) :
+		allocator(alloc),
+		indices(std::move(other.indices), alloc) {
+	}
+
+	~coalescing_indices() = default;
+
+	auto operator=(coalescing_indices const&) -> coalescing_indices& = delete;
+	auto operator=(coalescing_indices&&) noexcept -> coalescing_indices& = default;
+
+	template<typename KeyT>
+	auto get() -> coalescing_index<KeyT, AllocatorT>& {
+		using derived_type = coalescing_index<KeyT, AllocatorT>;
+
+		auto const id = type_id<KeyT>();
+
+		if (auto* const index = indices.find(id)) {
+			return static_cast<derived_type&>(*index);
+		}
+
+		return static_cast<derived_type&>(indices.insert(id, std::allocate_shared<derived_type>(allocator, allocator)));
+	}
+
+	auto clear() noexcept -> void {
+		for (auto const& index : indices) {
+			index->clear();
+		}
+	}
+
+private:
+	AllocatorT allocator;
+	dispatcher_table<generic_index, AllocatorT> indices;
+};
+
+}  //namespace events::detail
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace events::detail {
+
+/**
+ * @brief A @ref dispatcher_table whose lookups are safe to run concurrently with insertions, without locking
+ *
+ * @details Dispatchers are indexed by the @ref type_id of their event type in a two-level table of atomic pointers.
+ *          The first level holds up to 32 blocks, where each block is twice the size of the one before it, so the
+ *          table grows without ever moving the pointers a concurrent lookup may be reading. A lookup is two acquire
+ *          loads. Dispatchers are never removed, except by destroying, moving, or assigning to the table.
+ *
+ *          Only find() may be called concurrently with insert(). Insertions must be serialized with each other, and
+ *          iteration must be serialized with insertion, by the owner of the table.
+ *
+ *          A table keeps its blocks until it is destroyed, so find() may also be called on a table while it is moved
+ *          from. It returns either nullptr, or a dispatcher which is then owned by the table it was moved to. Moving
+ *          copies the index into the blocks of the destination, so unlike the table's other operations, it may throw.
+ */
+template<typename DispatcherT, typename AllocatorT>
+class concurrent_dispatcher_table {
+	using alloc_traits = std::allocator_traits<AllocatorT>;
+
+	using pointer_type = std::shared_ptr<DispatcherT>;
+	using pointer_allocator_type = typename alloc_traits::template rebind_alloc<pointer_type>;
+	using pointer_container_type = std::vector<pointer_type, pointer_allocator_type>;
+
+	using slot_type = std::atomic<DispatcherT*>;
+	using slot_allocator_type = typename alloc_traits::template rebind_alloc<slot_type>;
+	using slot_alloc_traits = std::allocator_traits<slot_allocator_type>;
+
+	static constexpr size_t first_block_size = 16;
+	static constexpr size_t block_count = 32;
+
+public:
+	explicit concurrent_dispatcher_table(AllocatorT const& alloc) : dispatchers(alloc), allocator(alloc) {
+	}
+
+	concurrent_dispatcher_table(concurrent_dispatcher_table const&) = delete;
+
+	concurrent_dispatcher_table(concurrent_dispatcher_table&& other) :
+		concurrent_dispatcher_table(std::move(other), other.allocator) {
+	}
+
+	// Delegates to the allocator constructor, so that the blocks are freed if copying the index throws
+	concurrent_dispatcher_table(concurrent_dispatcher_table&& other, AllocatorT const& alloc) :
+		concurrent_dispatcher_table(alloc) {
+		take_dispatchers(other);
+	}
+
+	~concurrent_dispatcher_table() {
+		free_blocks();
+	}
+
+	auto operator=(concurrent_dispatcher_table const&) -> concurrent_dispatcher_table& = delete;
+
+	/// This table's dispatchers are destroyed, so find() must not be called on it concurrently
+	auto operator=(concurrent_dispatcher_table&& other) -> concurrent_dispatcher_table& {
+		if (&other != this) {
+			take_dispatchers(other);
+		}
+		return *this;
+	}
+
+	/// Get the dispatcher for a type ID, or nullptr if there isn't one. Safe to call concurrently with insert().
+	[[nodiscard]]
+	auto find(size_t id) const noexcept -> DispatcherT* {
+		auto const b = block_of(id);
+
+		if (auto const* const block = blocks[b].load(std::memory_order_acquire)) {
+			return block[id - first_id(b)].load(std::memory_order_acquire);
+		}
+
+		return nullptr;
+	}
+
+	/// Add the dispatcher for a type ID. There must not already be a dispatcher for that ID.
+	auto insert(size_t id, pointer_type dispatcher) -> DispatcherT& {
+		auto& target = slot(id);
+		auto* const result = dispatcher.get();
+
+		dispatchers.push_back(std::move(dispatcher));
+
+		// Publish the dispatcher only once it is owned, so a lookup can't find a dispatcher that failed to insert
+		target.store(result, std::memory_order_release);
+		return *result;
+	}
+
+	/// Get a dispatcher by its position in creation order
+	[[nodiscard]]
+	auto operator[](size_t position) const noexcept -> DispatcherT& {
+		return *dispatchers[position];
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		return dispatchers.size();
+	}
+
+	[[nodiscard]]
+	auto begin() const noexcept {
+		return dispatchers.begin();
+	}
+
+	[[nodiscard]]
+	auto end() const noexcept {
+		return dispatchers.end();
+	}
+
+private:
+	// Block b holds the IDs from first_block_size * (2^b - 1), and has first_block_size * 2^b slots
+	[[nodiscard]]
+	static constexpr auto block_of(size_t id) noexcept -> size_t {
+		return static_cast<size_t>(std::bit_width(id / first_block_size + 1)) - 1;
+	}
+
+	[[nodiscard]]
+	static constexpr auto first_id(size_t block) noexcept -> size_t {
+		return first_block_size * ((size_t{1} << block) - 1);
+	}
+
+	[[nodiscard]]
+	static constexpr auto block_size(size_t block) noexcept -> size_t {
+		return first_block_size << block;
+	}
+
+	// Get the slot for a type ID, allocating its block if needed
+	auto slot(size_t id) -> slot_type& {
+		auto const b = block_of(id);
+		return get_or_create_block(b)[id - first_id(b)];
+	}
+
+	auto get_or_create_block(size_t b) -> slot_type* {
+		auto* result = blocks[b].load(std::memory_order_relaxed);
+
+		if (!result) {
+			auto alloc = slot_allocator_type{allocator};
+			result = slot_alloc_traits::allocate(alloc, block_size(b));
+			std::uninitialized_value_construct_n(result, block_size(b));
+			blocks[b].store(result, std::memory_order_release);
+		}
+
+		return result;
+	}
+
+	// Move the other table's dispatchers into this one, replacing its own. The index is copied into this table's
+	// blocks rather than taking the other's, since a concurrent find() may still be reading them. Every block that is
+	// needed is allocated before anything is changed, so neither table is modified if an allocation fails.
+	auto take_dispatchers(concurrent_dispatcher_table& other) -> void {
+		for (size_t b = 0; b < block_count; ++b) {
+			if (other.blocks[b].load(std::memory_order_relaxed)) {
+				get_or_create_block(b);
+			}
+		}
+
+		auto taken = pointer_container_type(std::move(other.dispatchers), dispatchers.get_allocator());
+
+		clear_slots();
+		for (size_t b = 0; b < block_count; ++b) {
+			if (auto const* const source = other.blocks[b].load(std::memory_order_relaxed)) {
+				auto* const target = blocks[b].load(std::memory_order_relaxed);
+
+				for (size_t i = 0; i < block_size(b); ++i) {
+					target[i].store(source[i].load(std::memory_order_relaxed), std::memory_order_release);
+				}
+			}
+		}
+
+		// The other table's dispatchers are owned by this one now, so its index only has to stop finding them
+		other.dispatchers.clear();
+		other.clear_slots();
+		dispatchers = std::move(taken);
+	}
+
+	auto clear_slots() noexcept -> void {
+		for (size_t b = 0; b < block_count; ++b) {
+			if (auto* const block = blocks[b].load(std::memory_order_relaxed)) {
+				for (size_t i = 0; i < block_size(b); ++i) {
+					block[i].store(nullptr, std::memory_order_relaxed);
+				}
+			}
+		}
+	}
+
+	auto free_blocks() noexcept -> void {
+		auto alloc = slot_allocator_type{allocator};
+
+		for (size_t b = 0; b < block_count; ++b) {
+			if (auto* const block = blocks[b].exchange(nullptr, std::memory_order_relaxed)) {
+				std::destroy_n(block, block_size(b));
+				slot_alloc_traits::deallocate(alloc, block, block_size(b));
+			}
+		}
+	}
+
+	pointer_container_type dispatchers;
+
+	AllocatorT allocator;
+	std::array<std::atomic<slot_type*>, block_count> blocks{};
+};
+
+}  //namespace events::detail
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+
+namespace events::detail {
+
+/**
+ * @brief A callable that invokes a member function known at compile time on a bound object. Holds nothing but the
+ *        object pointer, so it fits in the inline buffer of any callback wrapper, and the member function call can be
+ *        inlined into the wrapper's invoker.
+ */
+template<auto Candidate, typename ObjectT>
+struct member_delegate {
+	ObjectT* instance;
+
+	template<typename... ArgsT>
+	auto operator()(ArgsT&&... args) const -> decltype(auto) {
+		return std::invoke(Candidate, instance, std::forward<ArgsT>(args)...);
+	}
+};
+
+
+/// A stateless callable that invokes a free function known at compile time
+template<auto Candidate>
+struct function_delegate {
+	template<typename... ArgsT>
+	auto operator()(ArgsT&&... args) const -> decltype(auto) {
+		return std::invoke(Candidate, std::forward<ArgsT>(args)...);
+	}
+};
+
+
+// Extracts the decayed type of the first parameter of a function, function pointer, or member function pointer
+template<typename FunctionT>
+struct first_parameter;
+
+template<typename ReturnT, typename FirstT, typename... RestT>
+struct first_parameter<ReturnT(FirstT, RestT...)> {
+	using type = std::remove_cvref_t<FirstT>;
+};
+
+template<typename ReturnT, typename FirstT, typename... RestT>
+struct first_parameter<ReturnT(FirstT, RestT...) const> : first_parameter<ReturnT(FirstT, RestT...)> {};
+
+template<typename ReturnT, typename FirstT, typename... RestT>
+struct first_parameter<ReturnT(FirstT, RestT...) noexcept> : first_parameter<ReturnT(FirstT, RestT...)> {};
+
+template<typename ReturnT, typename FirstT, typename... RestT>
+struct first_parameter<ReturnT(FirstT, RestT...) const noexcept> : first_parameter<ReturnT(FirstT, RestT...)> {};
+
+template<typename FunctionT>
+struct first_parameter<FunctionT*> : first_parameter<FunctionT> {};
+
+template<typename FunctionT, typename ClassT>
+struct first_parameter<FunctionT ClassT::*> : first_parameter<FunctionT> {};
+
+
+/// The event type handled by a function or member function, deduced from its first parameter
+template<auto Candidate>
+using delegate_event_t = typename first_parameter<std::remove_cv_t<decltype(Candidate)>>::type;
+
+}  //namespace events::detail
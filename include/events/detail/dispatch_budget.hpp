@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+
+namespace events::detail {
+
+/**
+ * @brief Limits how many events a budgeted dispatch may publish, by count or by time. The budget is shared by all of
+ *        the event types visited by one dispatch call.
+ */
+class dispatch_budget {
+public:
+	using clock_type = std::chrono::steady_clock;
+
+	explicit dispatch_budget(size_t max_events) noexcept : remaining(max_events) {
+	}
+
+	explicit dispatch_budget(clock_type::time_point end_time) noexcept : deadline(end_time), has_deadline(true) {
+	}
+
+	/// Claim the budget for one more event. Returns false, and exhausts the budget, if there is none left.
+	[[nodiscard]]
+	auto take() noexcept -> bool {
+		if (remaining == 0) {
+			return false;
+		}
+
+		if (has_deadline && clock_type::now() >= deadline) {
+			remaining = 0;
+			return false;
+		}
+
+		--remaining;
+		++used;
+		return true;
+	}
+
+	/// Claim the budget for up to count events at once. Returns the number of events claimed.
+	[[nodiscard]]
+	auto take(size_t count) noexcept -> size_t {
+		if (has_deadline && clock_type::now() >= deadline) {
+			remaining = 0;
+			return 0;
+		}
+
+		auto const claimed = std::min(count, remaining);
+		remaining -= claimed;
+		used += claimed;
+		return claimed;
+	}
+
+	/// True once a call to take() has failed, or all events allowed by a count budget have been claimed
+	[[nodiscard]]
+	auto exhausted() const noexcept -> bool {
+		return remaining == 0;
+	}
+
+	/// Get the number of events claimed so far
+	[[nodiscard]]
+	auto dispatched() const noexcept -> size_t {
+		return used;
+	}
+
+private:
+	size_t remaining = std::numeric_limits<size_t>::max();
+	size_t used = 0;
+
+	clock_type::time_point deadline;
+	bool has_deadline = false;
+};
+
+}  //namespace events::detail
@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/execution_context.hpp>
+#include <boost/asio/is_executor.hpp>
+#include <boost/asio/execution/executor.hpp>
+#include <boost/asio/post.hpp>
+
+
+namespace events::detail {
+
+/// An ASIO executor, or an execution context such as a thread pool, that work can be posted to
+template<typename T>
+concept executor_or_context = boost::asio::execution::is_executor<std::remove_cvref_t<T>>::value
+                           || boost::asio::is_executor<std::remove_cvref_t<T>>::value
+                           || std::derived_from<std::remove_cvref_t<T>, boost::asio::execution_context>;
+
+
+/**
+ * @brief The ordering constraints between the discrete dispatchers of an event dispatcher, for a parallel dispatch
+ *
+ * @details Dispatchers are identified by their position in creation order, which never changes. An edge from one
+ *          dispatcher to another means the second may only be dispatched once the first has finished. Edges that
+ *          would form a cycle are rejected. The graph is not thread-safe.
+ */
+template<typename AllocatorT>
+class dispatch_graph {
+	using alloc_traits = std::allocator_traits<AllocatorT>;
+
+	using index_allocator_type = typename alloc_traits::template rebind_alloc<size_t>;
+	using index_container_type = std::vector<size_t, index_allocator_type>;
+
+	using successor_allocator_type = typename alloc_traits::template rebind_alloc<index_container_type>;
+	using successor_container_type = std::vector<index_container_type, successor_allocator_type>;
+
+public:
+	explicit dispatch_graph(AllocatorT const& alloc) : successors(alloc), predecessor_counts(alloc) {
+	}
+
+	dispatch_graph(dispatch_graph const&) = delete;
+
+	dispatch_graph(dispatch_graph&&) noexcept = default;
+
+	dispatch_graph(dispatch_graph&& other, AllocatorT const& alloc) :
+		successors(alloc),
+		predecessor_counts(std::move(other.predecessor_counts), alloc) {
+		successors.reserve(other.successors.size());
+		for (auto& list : other.successors) {
+			successors.emplace_back(std::move(list), alloc);
+		}
+		other.successors.clear();
+	}
+
+	~dispatch_graph() = default;
+
+	auto operator=(dispatch_graph const&) -> dispatch_graph& = delete;
+	auto operator=(dispatch_graph&&) noexcept -> dispatch_graph& = default;
+
+	/// Require the dispatcher at position "after" to be dispatched after the one at position "before". Returns false,
+	/// and adds nothing, if that would form a cycle.
+	auto add_edge(size_t before, size_t after) -> bool {
+		if (before == after || reaches(after, before)) {
+			return false;
+		}
+
+		auto const size = std::max(before, after) + 1;
+		if (size > successors.size()) {
+			successors.resize(size, index_container_type{successors.get_allocator()});
+			predecessor_counts.resize(size, 0);
+		}
+
+		auto& list = successors[before];
+		if (std::ranges::find(list, after) == list.end()) {
+			list.push_back(after);
+			++predecessor_counts[after];
+		}
+
+		return true;
+	}
+
+	/// Get the dispatchers that wait on the dispatcher at a position
+	[[nodiscard]]
+	auto successors_of(size_t position) const noexcept -> index_container_type const* {
+		return position < successors.size() ? &successors[position] : nullptr;
+	}
+
+	/// Get the number of dispatchers the dispatcher at a position waits on
+	[[nodiscard]]
+	auto predecessor_count(size_t position) const noexcept -> size_t {
+		return position < predecessor_counts.size() ? predecessor_counts[position] : 0;
+	}
+
+private:
+	// Check if there is a path of edges from one position to another
+	[[nodiscard]]
+	auto reaches(size_t from, size_t to) const -> bool {
+		auto visited = std::vector<bool, typename alloc_traits::template rebind_alloc<bool>>(
+			successors.size(), false, successors.get_allocator()
+		);
+		auto pending = index_container_type{successors.get_allocator()};
+
+		pending.push_back(from);
+
+		while (!pending.empty()) {
+			auto const position = pending.back();
+			pending.pop_back();
+
+			if (position == to) {
+				return true;
+			}
+			if (position >= successors.size() || visited[position]) {
+				continue;
+			}
+
+			visited[position] = true;
+			pending.insert(pending.end(), successors[position].begin(), successors[position].end());
+		}
+
+		return false;
+	}
+
+	successor_container_type successors;
+	index_container_type predecessor_counts;
+};
+
+
+/**
+ * @brief Dispatch every dispatcher in a table on an executor, respecting the order constraints of a dispatch graph,
+ *        and wait for all of them to finish.
+ *
+ * @details Dispatchers with no unfinished predecessors are put in a ready list, and a task that runs one of them is
+ *          posted to the executor for each. The calling thread also takes dispatchers from the ready list until every
+ *          dispatcher has finished, so the dispatch completes even if the executor never runs the posted tasks, e.g.
+ *          an io_context that isn't being run, or a single-threaded pool that is running the caller. Tasks that run
+ *          after the dispatch finished find the ready list empty and do nothing.
+ *
+ *          When a dispatcher finishes, the thread that ran it continues with one newly ready successor. If a
+ *          dispatcher throws, dispatchers that haven't started yet are skipped, and the first exception is rethrown
+ *          once the others have finished.
+ */
+template<typename TableT, typename AllocatorT, typename ExecutorT>
+auto parallel_dispatch(TableT const& dispatchers, dispatch_graph<AllocatorT> const& graph, ExecutorT& executor, AllocatorT const& alloc) -> void {
+	using index_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<size_t>;
+	using index_container_type = std::vector<size_t, index_allocator_type>;
+
+	// Tasks keep a copy of the executor, since they may outlive an executor or context passed by reference
+	auto const executor_copy = [&] {
+		if constexpr (std::derived_from<std::remove_cv_t<ExecutorT>, boost::asio::execution_context>) {
+			return executor.get_executor();
+		}
+		else {
+			return std::remove_cv_t<ExecutorT>{executor};
+		}
+	};
+
+	using executor_type = decltype(executor_copy());
+
+	static constexpr auto none = static_cast<size_t>(-1);
+
+	auto const count = dispatchers.size();
+	if (count == 0) {
+		return;
+	}
+
+	// Shared with the posted tasks, which may outlive this call
+	struct state_type : std::enable_shared_from_this<state_type> {
+		state_type(TableT const& table, dispatch_graph<AllocatorT> const& order, executor_type exec, size_t size, AllocatorT const& a) :
+			dispatchers(table),
+			graph(order),
+			executor(std::move(exec)),
+			pending(size, 0, index_allocator_type{a}),
+			ready(index_allocator_type{a}),
+			remaining(size) {
+			ready.reserve(size);
+		}
+
+		// Take a dispatcher from the ready list, or none if it is empty. Requires mut.
+		auto pop_ready() -> size_t {
+			if (ready.empty()) {
+				return none;
+			}
+
+			auto const position = ready.back();
+			ready.pop_back();
+			return position;
+		}
+
+		// Post a task for each of a number of dispatchers added to the ready list. If posting fails, the caller runs
+		// them instead.
+		auto post(size_t readied) -> void {
+			for (size_t i = 0; i < readied; ++i) {
+				try {
+					boost::asio::post(executor, [self = this->shared_from_this()] {
+						auto position = none;
+						{
+							auto lock = std::scoped_lock{self->mut};
+							position = self->pop_ready();
+						}
+						self->post(self->run(position));
+					});
+				}
+				catch (...) {
+					return;
+				}
+			}
+		}
+
+		// Dispatch a dispatcher, then keep going with one of the successors it made ready. Returns the number of
+		// other successors added to the ready list.
+		auto run(size_t position) -> size_t {
+			auto readied = size_t{0};
+
+			while (position != none) {
+				if (!failed.load(std::memory_order_relaxed)) {
+					try {
+						dispatchers[position].dispatch();
+					}
+					catch (...) {
+						auto lock = std::scoped_lock{mut};
+						if (!error) {
+							error = std::current_exception();
+						}
+						failed.store(true, std::memory_order_relaxed);
+					}
+				}
+
+				auto next = none;
+				{
+					auto lock = std::scoped_lock{mut};
+
+					if (auto const* const list = graph.successors_of(position)) {
+						for (auto const successor : *list) {
+							if (--pending[successor] != 0) {
+								continue;
+							}
+							if (next == none) {
+								next = successor;
+							}
+							else {
+								ready.push_back(successor);
+								++readied;
+							}
+						}
+					}
+
+					--remaining;
+				}
+
+				// The caller may be waiting for more ready dispatchers, or for the last one to finish
+				finished.notify_one();
+				position = next;
+			}
+
+			return readied;
+		}
+
+		TableT const& dispatchers;
+		dispatch_graph<AllocatorT> const& graph;
+		executor_type executor;
+
+		std::mutex mut;
+		std::condition_variable finished;
+
+		index_container_type pending;
+		index_container_type ready;
+		size_t remaining;
+
+		std::atomic<bool> failed = false;
+		std::exception_ptr error;
+	};
+
+	auto const state = std::allocate_shared<state_type>(alloc, dispatchers, graph, executor_copy(), count, alloc);
+
+	auto first = none;
+	auto roots = size_t{0};
+	{
+		auto lock = std::scoped_lock{state->mut};
+
+		for (size_t i = 0; i < count; ++i) {
+			state->pending[i] = graph.predecessor_count(i);
+
+			if (state->pending[i] != 0) {
+				continue;
+			}
+			if (first == none) {
+				first = i;
+			}
+			else {
+				state->ready.push_back(i);
+				++roots;
+			}
+		}
+	}
+
+	state->post(roots);
+	state->post(state->run(first));
+
+	// Help with the ready dispatchers until all of them have finished
+	while (true) {
+		auto position = none;
+		{
+			auto lock = std::unique_lock{state->mut};
+			state->finished.wait(lock, [&] { return state->remaining == 0 || !state->ready.empty(); });
+
+			if (state->remaining == 0) {
+				break;
+			}
+
+			position = state->pop_ready();
+		}
+
+		state->post(state->run(position));
+	}
+
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+
+}  //namespace events::detail
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace events::detail {
+
+/**
+ * @brief Owns the discrete dispatchers of an event dispatcher, and looks them up by the @ref type_id of their event
+ *        type with a single array index.
+ *
+ * @details Dispatchers are also kept in a dense list in the order they were created, so that iterating over them
+ *          doesn't visit the IDs of event types this table has never seen. The table is not thread-safe.
+ */
+template<typename DispatcherT, typename AllocatorT>
+class dispatcher_table {
+	using alloc_traits = std::allocator_traits<AllocatorT>;
+
+	using pointer_type = std::shared_ptr<DispatcherT>;
+	using pointer_allocator_type = typename alloc_traits::template rebind_alloc<pointer_type>;
+	using pointer_container_type = std::vector<pointer_type, pointer_allocator_type>;
+	using index_container_type = std::vector<DispatcherT*, typename alloc_traits::template rebind_alloc<DispatcherT*>>;
+
+public:
+	explicit dispatcher_table(AllocatorT const& alloc) : dispatchers(alloc), index(alloc) {
+	}
+
+	dispatcher_table(dispatcher_table const&) = delete;
+
+	dispatcher_table(dispatcher_table&&) noexcept = default;
+
+	dispatcher_table(dispatcher_table&& other, AllocatorT const& alloc) :
+		dispatchers(std::move(other.dispatchers), alloc),
+		index(std::move(other.index), alloc) {
+	}
+
+	~dispatcher_table() = default;
+
+	auto operator=(dispatcher_table const&) -> dispatcher_table& = delete;
+	auto operator=(dispatcher_table&&) noexcept -> dispatcher_table& = default;
+
+	/// Get the dispatcher for a type ID, or nullptr if there isn't one
+	[[nodiscard]]
+	auto find(size_t id) const noexcept -> DispatcherT* {
+		return id < index.size() ? index[id] : nullptr;
+	}
+
+	/// Add the dispatcher for a type ID. There must not already be a dispatcher for that ID.
+	auto insert(size_t id, pointer_type dispatcher) -> DispatcherT& {
+		if (id >= index.size()) {
+			index.resize(id + 1, nullptr);
+		}
+
+		index[id] = dispatcher.get();
+		dispatchers.push_back(std::move(dispatcher));
+
+		return *index[id];
+	}
+
+	/// Get a dispatcher by its position in creation order
+	[[nodiscard]]
+	auto operator[](size_t position) const noexcept -> DispatcherT& {
+		return *dispatchers[position];
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		return dispatchers.size();
+	}
+
+	[[nodiscard]]
+	auto begin() const noexcept {
+		return dispatchers.begin();
+	}
+
+	[[nodiscard]]
+	auto end() const noexcept {
+		return dispatchers.end();
+	}
+
+private:
+	pointer_container_type dispatchers;
+	index_container_type index;
+};
+
+}  //namespace events::detail
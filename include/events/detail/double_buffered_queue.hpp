@@ -0,0 +1,512 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <events/detail/coalescing_index.hpp>
+
+
+namespace events {
+
+/**
+ * @brief Controls when an event dispatcher releases queue memory it no longer needs. Event queues keep their capacity
+ *        between dispatches, so that a steady flow of events doesn't allocate. With a shrink policy, a queue tracks the
+ *        largest number of events dispatched at once (the high-water mark) over a window of dispatches, and at the end
+ *        of each window shrinks any buffer whose capacity exceeds that mark by more than a given factor.
+ *
+ * @details The default policy never shrinks.
+ */
+struct shrink_policy {
+	/// The number of dispatches over which the high-water mark is measured. 0 disables shrinking.
+	size_t window = 0;
+
+	/// A buffer is shrunk to the high-water mark when its capacity is more than this many times larger
+	size_t factor = 4;
+};
+
+
+/**
+ * @brief Selects what happens when an event is enqueued to a queue that has reached its capacity
+ *
+ * @details drop_oldest and overwrite_newest replace a pending event in place, which requires the event type to be
+ *          move assignable. For other event types, they drop the new event instead.
+ */
+enum class overflow_policy {
+	drop_newest,       ///< Discard the new event
+	drop_oldest,       ///< Discard the oldest pending event, and enqueue the new event
+	overwrite_newest,  ///< Replace the newest pending event with the new event
+	reject             ///< Discard the new event without counting it as dropped. Only the return value reports it.
+};
+
+
+namespace detail {
+
+/**
+ * @brief An event queue made of two buffers which are swapped on dispatch, so that each keeps its capacity. Events are
+ *        enqueued to the back buffer, while the front buffer holds the events being dispatched.
+ *
+ * @details The queue itself is not thread-safe, with one exception: a batch of dispatched events may be released
+ *          without holding the lock that guards the rest of the queue. If a batch is acquired while another batch is
+ *          still in use, e.g. when dispatching from within a callback, the back buffer is moved into the new batch
+ *          instead of being swapped.
+ *
+ *          A queue may be given a capacity. Once full, the back buffer is used as a ring buffer by the drop_oldest
+ *          policy, and is rotated back into order before it's appended to or taken for dispatch.
+ */
+template<typename EventT, typename AllocatorT>
+class double_buffered_queue {
+	using event_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<EventT>;
+
+public:
+	using container_type = std::vector<EventT, event_allocator_type>;
+
+	/**
+	 * @brief A set of events taken from the queue for dispatch. The events are destroyed when the batch is destroyed,
+	 *        unless the batch was only partially dispatched.
+	 */
+	class [[nodiscard]] batch {
+	public:
+		batch(batch const&) = delete;
+		batch(batch&&) = delete;
+
+		~batch() {
+			if (queue) {
+				queue->release(dispatched);
+			}
+		}
+
+		auto operator=(batch const&) -> batch& = delete;
+		auto operator=(batch&&) -> batch& = delete;
+
+		[[nodiscard]]
+		auto events() noexcept -> std::span<EventT> {
+			if (queue) {
+				return std::span{queue->front}.subspan(queue->front_pos);
+			}
+			return std::span{owned};
+		}
+
+		/**
+		 * @brief Return the events after the first count to the queue when this batch is destroyed. They will be the
+		 *        first events of the next batch. Only a batch from resume() can be partially dispatched.
+		 */
+		auto keep_after(size_t count) noexcept -> void {
+			dispatched = count;
+		}
+
+		[[nodiscard]]
+		auto begin() noexcept {
+			return events().begin();
+		}
+
+		[[nodiscard]]
+		auto end() noexcept {
+			return events().end();
+		}
+
+	private:
+		friend class double_buffered_queue;
+
+		explicit batch(double_buffered_queue& source) noexcept : queue(&source) {
+		}
+
+		explicit batch(container_type&& events) noexcept : owned(std::move(events)) {
+		}
+
+		double_buffered_queue* queue = nullptr;
+		container_type owned;
+		size_t dispatched = std::numeric_limits<size_t>::max();
+	};
+
+	double_buffered_queue() = default;
+
+	explicit double_buffered_queue(AllocatorT const& alloc) : back(alloc), front(alloc), coalesced(alloc) {
+	}
+
+	double_buffered_queue(shrink_policy shrink, AllocatorT const& alloc) :
+		back(alloc),
+		front(alloc),
+		coalesced(alloc),
+		policy(shrink) {
+	}
+
+	double_buffered_queue(double_buffered_queue const&) = delete;
+
+	double_buffered_queue(double_buffered_queue&& other) noexcept :
+		back(std::move(other.back)),
+		front(std::move(other.front)),
+		coalesced(std::move(other.coalesced)),
+		front_pos(std::exchange(other.front_pos, 0)),
+		kept(other.kept.exchange(0, std::memory_order_relaxed)),
+		limit(other.limit),
+		overflow(other.overflow),
+		head(std::exchange(other.head, 0)),
+		dropped_events(other.dropped_events.load(std::memory_order_relaxed)),
+		policy(other.policy) {
+	}
+
+	double_buffered_queue(double_buffered_queue&& other, AllocatorT const& alloc) :
+		back(std::move(other.back), alloc),
+		front(std::move(other.front), alloc),
+		coalesced(std::move(other.coalesced), alloc),
+		front_pos(std::exchange(other.front_pos, 0)),
+		kept(other.kept.exchange(0, std::memory_order_relaxed)),
+		limit(other.limit),
+		overflow(other.overflow),
+		head(std::exchange(other.head, 0)),
+		dropped_events(other.dropped_events.load(std::memory_order_relaxed)),
+		policy(other.policy) {
+	}
+
+	~double_buffered_queue() = default;
+
+	auto operator=(double_buffered_queue const&) -> double_buffered_queue& = delete;
+
+	auto operator=(double_buffered_queue&& other) noexcept -> double_buffered_queue& {
+		back = std::move(other.back);
+		front = std::move(other.front);
+		coalesced = std::move(other.coalesced);
+		front_pos = std::exchange(other.front_pos, 0);
+		kept.store(other.kept.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+		limit = other.limit;
+		overflow = other.overflow;
+		head = std::exchange(other.head, 0);
+		dropped_events.store(other.dropped_events.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		policy = other.policy;
+		high_water = 0;
+		dispatch_count = 0;
+		shrink_limit = std::numeric_limits<size_t>::max();
+		return *this;
+	}
+
+	/**
+	 * @brief Limit the number of pending events. Events which are already pending are kept, even if there are more
+	 *        than the new capacity.
+	 *
+	 * @param capacity     The maximum number of pending events, or 0 for no limit
+	 * @param on_overflow  What to do with an event that is enqueued while the queue is full
+	 */
+	auto set_capacity(size_t capacity, overflow_policy on_overflow) -> void {
+		unwrap();
+		limit = capacity;
+		overflow = on_overflow;
+		back.reserve(capacity);
+	}
+
+	/// Get the number of events that were discarded because the queue was full
+	[[nodiscard]]
+	auto dropped() const noexcept -> size_t {
+		return dropped_events.load(std::memory_order_relaxed);
+	}
+
+	/// Enqueue an event. Returns false if the queue was full and the event was discarded.
+	template<typename... ArgsT>
+	auto emplace(ArgsT&&... args) -> bool {
+		if (limit != 0) [[unlikely]] {
+			return emplace_bounded(std::forward<ArgsT>(args)...);
+		}
+
+		back.emplace_back(std::forward<ArgsT>(args)...);
+		return true;
+	}
+
+	/// Enqueue a range of events. Returns the number of events that were enqueued.
+	template<std::ranges::range RangeT>
+	auto insert(RangeT&& range) -> size_t {
+		if (limit != 0) [[unlikely]] {
+			auto count = size_t{0};
+			for (auto&& event : range) {
+				if (emplace_bounded(std::forward<decltype(event)>(event))) {
+					++count;
+				}
+			}
+			return count;
+		}
+
+		auto const old_size = back.size();
+		back.insert(back.end(), std::ranges::begin(range), std::ranges::end(range));
+		return back.size() - old_size;
+	}
+
+	/**
+	 * @brief Enqueue an event, or merge it into the pending event with the same key if there is one. The merged event
+	 *        keeps the position of the pending event.
+	 *
+	 * @param key    The key that identifies which events are coalesced
+	 * @param event  The event to enqueue
+	 * @param merge  A function invoked with the pending event and the new event, which updates the pending event
+	 *
+	 * @return False if the queue was full and the event was discarded
+	 */
+	template<typename KeyT, typename MergeT>
+	auto emplace_coalesced(KeyT const& key, EventT&& event, MergeT& merge) -> bool {
+		unwrap();
+
+		auto& index = coalesced.template get<KeyT>();
+		auto const [position, inserted] = index.try_emplace(key, back.size());
+
+		if (!inserted) {
+			std::invoke(merge, back[position], std::move(event));
+			return true;
+		}
+
+		if (limit != 0 && full()) [[unlikely]] {
+			// The event isn't appended, so it can't be found by its key
+			index.erase(key);
+			return emplace_bounded(std::move(event));
+		}
+
+		try {
+			back.push_back(std::move(event));
+		}
+		catch (...) {
+			index.erase(key);
+			throw;
+		}
+
+		return true;
+	}
+
+	/// Get the number of enqueued events, including those left over by a partial dispatch, but not counting a batch
+	/// that is being dispatched
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		return back.size() + kept.load(std::memory_order_relaxed);
+	}
+
+	/// Destroy all enqueued events, keeping the capacity of the queue
+	auto clear() noexcept -> void {
+		back.clear();
+		head = 0;
+		coalesced.clear();
+
+		if (!front_in_use.exchange(true, std::memory_order_acquire)) {
+			front.clear();
+			front_pos = 0;
+			kept.store(0, std::memory_order_relaxed);
+			front_in_use.store(false, std::memory_order_release);
+		}
+	}
+
+	/**
+	 * @brief Take all enqueued events for dispatch by swapping the buffers. The back buffer is left empty, with the
+	 *        capacity of the previous batch. Events left over by a partial dispatch come first.
+	 */
+	auto acquire() -> batch {
+		return take(false);
+	}
+
+	/**
+	 * @brief Take all enqueued events for a dispatch that may stop partway through. If another batch is in use, an
+	 *        empty batch is returned instead, since the other batch may also be returning events to the queue.
+	 */
+	auto resume() -> batch {
+		return take(true);
+	}
+
+private:
+	[[nodiscard]]
+	auto full() const noexcept -> bool {
+		return back.size() + kept.load(std::memory_order_relaxed) >= limit;
+	}
+
+	template<typename... ArgsT>
+	auto emplace_bounded(ArgsT&&... args) -> bool {
+		if (!full()) {
+			unwrap();
+			back.emplace_back(std::forward<ArgsT>(args)...);
+			return true;
+		}
+
+		if (overflow == overflow_policy::reject) {
+			return false;
+		}
+
+		dropped_events.fetch_add(1, std::memory_order_relaxed);
+
+		if constexpr (std::is_move_assignable_v<EventT>) {
+			// Pending events may all be left over from a partial dispatch, which can't be replaced from here
+			if (overflow == overflow_policy::drop_newest || back.empty()) {
+				return false;
+			}
+
+			auto event = EventT(std::forward<ArgsT>(args)...);
+
+			// Replacing an event invalidates the keys of the coalescing indices
+			coalesced.clear();
+
+			if (overflow == overflow_policy::drop_oldest) {
+				back[head] = std::move(event);
+				head = (head + 1) % back.size();
+			}
+			else {
+				back[(head + back.size() - 1) % back.size()] = std::move(event);
+			}
+			return true;
+		}
+		else {
+			return false;
+		}
+	}
+
+	// Rotate the back buffer so that the oldest event is first, after it was used as a ring buffer
+	auto unwrap() -> void {
+		if constexpr (std::is_move_assignable_v<EventT>) {
+			if (head != 0) {
+				std::rotate(back.begin(), back.begin() + static_cast<ptrdiff_t>(head), back.end());
+				head = 0;
+				coalesced.clear();
+			}
+		}
+	}
+
+	auto take(bool partial) -> batch {
+		unwrap();
+
+		if (front_in_use.exchange(true, std::memory_order_acquire)) {
+			if (partial) {
+				return batch{container_type(back.get_allocator())};
+			}
+
+			coalesced.clear();
+			return batch{std::exchange(back, container_type(back.get_allocator()))};
+		}
+
+		coalesced.clear();
+
+		// The capacity may be changed while the batch is dispatched, so snapshot it for shrink_if_needed()
+		front_bounded = (limit != 0);
+
+		if (front.empty()) {
+			std::swap(front, back);
+		}
+		else {
+			// Append to the events left over by a partial dispatch, so that they're dispatched first
+			try {
+				discard_dispatched();
+				std::ranges::move(back, std::back_inserter(front));
+			}
+			catch (...) {
+				front_in_use.store(false, std::memory_order_release);
+				throw;
+			}
+
+			back.clear();
+			kept.store(0, std::memory_order_relaxed);
+		}
+
+		return batch{*this};
+	}
+
+	// Destroy the events a partial dispatch already dispatched, moving the events it left over to the start of the
+	// front buffer. Otherwise they would pile up in front of the leftovers for as long as no dispatch drains the queue.
+	auto discard_dispatched() -> void {
+		if (front_pos == 0) {
+			return;
+		}
+
+		auto const first_kept = front.begin() + static_cast<ptrdiff_t>(front_pos);
+
+		if constexpr (std::is_move_assignable_v<EventT>) {
+			front.erase(front.begin(), first_kept);
+		}
+		else {
+			auto leftovers = container_type(front.get_allocator());
+			leftovers.reserve(front.capacity());
+			std::move(first_kept, front.end(), std::back_inserter(leftovers));
+			front.swap(leftovers);
+		}
+
+		front_pos = 0;
+	}
+
+	// Called once a batch has been dispatched. Only the thread that acquired the front buffer may access it.
+	auto release(size_t dispatched) noexcept -> void {
+		if (auto const remaining = front.size() - front_pos; dispatched < remaining) {
+			front_pos += dispatched;
+			kept.store(remaining - dispatched, std::memory_order_relaxed);
+
+			// Otherwise the dispatched events are discarded by the next take(), which is allowed to throw
+			if constexpr (std::is_nothrow_move_assignable_v<EventT>) {
+				discard_dispatched();
+			}
+		}
+		else {
+			shrink_if_needed();
+			front.clear();
+			front_pos = 0;
+			kept.store(0, std::memory_order_relaxed);
+		}
+
+		front_in_use.store(false, std::memory_order_release);
+	}
+
+	// Track the high-water mark over each window, and shrink the front buffer if it's too large for the mark of the
+	// last complete window. The buffers alternate as the front buffer, so both are checked. A bounded queue keeps the
+	// capacity it reserved. This runs without the enqueue lock, so it reads the bound as it was when the front buffer
+	// was taken.
+	auto shrink_if_needed() noexcept -> void {
+		if (policy.window == 0 || front_bounded) {
+			return;
+		}
+
+		high_water = std::max(high_water, front.size());
+
+		if (++dispatch_count >= policy.window) {
+			shrink_limit = high_water;
+			high_water = 0;
+			dispatch_count = 0;
+		}
+
+		if (front.capacity() / std::max<size_t>(policy.factor, 1) > shrink_limit) {
+			try {
+				auto shrunk = container_type(front.get_allocator());
+				shrunk.reserve(shrink_limit);
+				front = std::move(shrunk);
+			}
+			catch (...) {
+				// Failing to shrink is harmless, the old buffer is kept
+			}
+		}
+	}
+
+	container_type back;
+	container_type front;
+
+	// The positions in the back buffer of events that were enqueued with a key
+	coalescing_indices<AllocatorT> coalesced;
+
+	// The position of the first event in the front buffer that hasn't been dispatched, after a partial dispatch
+	size_t front_pos = 0;
+
+	// The number of events left in the front buffer by a partial dispatch
+	std::atomic<size_t> kept = 0;
+
+	std::atomic<bool> front_in_use = false;
+
+	// Whether the queue was bounded when the front buffer was taken. Owned by the thread that holds the front buffer.
+	bool front_bounded = false;
+
+	size_t limit = 0;  //0 if the queue is unbounded
+	overflow_policy overflow = overflow_policy::drop_newest;
+	size_t head = 0;   //the position of the oldest event in the back buffer, while it's used as a ring buffer
+	std::atomic<size_t> dropped_events = 0;
+
+	shrink_policy policy;
+	size_t high_water = 0;
+	size_t dispatch_count = 0;
+	size_t shrink_limit = std::numeric_limits<size_t>::max();
+};
+
+}  //namespace detail
+}  //namespace events
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+namespace events::detail {
+
+/**
+ * @brief Tracks the readers of a shared value which is replaced, rather than modified, by writers. A replaced value may
+ *        be reclaimed once no reader can still refer to it.
+ *
+ * @details Readers register in one of two phases, chosen by the current epoch, and in one of several stripes, chosen
+ *          per thread, so that concurrent readers rarely write to the same cache line. A value which was replaced can
+ *          be reclaimed once each phase has been seen without readers at some point after the replacement. Checking
+ *          the phases flips the epoch, so that new readers join the other phase and the checked phase can drain even
+ *          while readers keep arriving.
+ *
+ *          Readers must load the shared value after entering, and writers must check the phases after replacing it.
+ *          Both sides use sequentially consistent operations, so a reader either sees the new value or is seen by the
+ *          writer's check.
+ */
+class epoch_readers {
+	static constexpr size_t stripe_count = 16;
+	static constexpr size_t cache_line_size = 64;
+
+	struct alignas(cache_line_size) stripe {
+		std::array<std::atomic<size_t>, 2> readers{};
+	};
+
+public:
+	/// Registers a reader for the lifetime of the guard
+	class [[nodiscard]] read_guard {
+	public:
+		explicit read_guard(epoch_readers& tracker) noexcept :
+			counter(&tracker.stripes[stripe_index()].readers[tracker.epoch.load(std::memory_order_relaxed)]) {
+			counter->fetch_add(1, std::memory_order_seq_cst);
+		}
+
+		read_guard(read_guard const&) = delete;
+		read_guard(read_guard&&) = delete;
+
+		~read_guard() {
+			counter->fetch_sub(1, std::memory_order_release);
+		}
+
+		auto operator=(read_guard const&) -> read_guard& = delete;
+		auto operator=(read_guard&&) -> read_guard& = delete;
+
+	private:
+		std::atomic<size_t>* counter;
+	};
+
+	/// The bit set in the result of idle_phases() for each phase
+	static constexpr unsigned all_phases = 0b11;
+
+	epoch_readers() = default;
+	epoch_readers(epoch_readers const&) = delete;
+	epoch_readers(epoch_readers&&) = delete;
+
+	~epoch_readers() = default;
+
+	auto operator=(epoch_readers const&) -> epoch_readers& = delete;
+	auto operator=(epoch_readers&&) -> epoch_readers& = delete;
+
+	/**
+	 * @brief Check which phases currently have no readers, then flip the epoch. Must not be called concurrently with
+	 *        itself.
+	 *
+	 * @return A mask with bit n set if phase n had no readers
+	 */
+	auto idle_phases() noexcept -> unsigned {
+		auto result = 0u;
+
+		for (size_t phase = 0; phase < 2; ++phase) {
+			auto const idle = std::ranges::all_of(stripes, [phase](stripe const& s) {
+				return s.readers[phase].load(std::memory_order_seq_cst) == 0;
+			});
+
+			if (idle) {
+				result |= 1u << phase;
+			}
+		}
+
+		epoch.store(epoch.load(std::memory_order_relaxed) ^ 1, std::memory_order_relaxed);
+		return result;
+	}
+
+private:
+	// Threads are assigned stripes round robin, the first time they read
+	static auto stripe_index() noexcept -> size_t {
+		static auto next_index = std::atomic<size_t>{0};
+		thread_local auto const index = next_index.fetch_add(1, std::memory_order_relaxed) % stripe_count;
+		return index;
+	}
+
+	std::array<stripe, stripe_count> stripes;
+	std::atomic<size_t> epoch = 0;
+};
+
+}  //namespace events::detail
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace events::detail {
+
+/**
+ * @brief A queue of events of any type, stored back to back in a single contiguous buffer. Each event is preceded by a
+ *        small header identifying its type and the target it will be published to, so the queue can be published in
+ *        one linear pass in exact insertion order.
+ *
+ * @details When the buffer grows, events are relocated into the new buffer by move construction, so event types must
+ *          be nothrow move constructible. Event types may not be over-aligned.
+ */
+template<typename AllocatorT>
+class event_arena {
+	struct record_ops {
+		void (*publish)(void* target, void const* event);
+		void (*relocate)(void* dest, void* src) noexcept;
+		void (*destroy)(void* event) noexcept;
+	};
+
+	struct record_header {
+		record_ops const* ops;
+		void* target;
+		uint32_t event_offset;  //offset from this header to the event
+		uint32_t next;          //offset from this header to the next header
+	};
+
+	struct alignas(std::max_align_t) block {
+		std::byte bytes[alignof(std::max_align_t)];  //NOLINT(*-avoid-c-arrays)
+	};
+
+	using block_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<block>;
+	using block_traits = std::allocator_traits<block_allocator_type>;
+
+	static constexpr size_t min_capacity = 16 * sizeof(block);
+
+	template<typename EventT, typename TargetT>
+	static constexpr auto ops_for = record_ops{
+		[](void* target, void const* event) {
+			static_cast<TargetT*>(target)->publish(*static_cast<EventT const*>(event));
+		},
+		[](void* dest, void* src) noexcept {
+			auto* const event = static_cast<EventT*>(src);
+			::new (dest) EventT(std::move(*event));
+			std::destroy_at(event);
+		},
+		[](void* event) noexcept {
+			std::destroy_at(static_cast<EventT*>(event));
+		}
+	};
+
+public:
+	explicit event_arena(AllocatorT const& alloc) : allocator(alloc) {
+	}
+
+	event_arena(event_arena const&) = delete;
+
+	event_arena(event_arena&& other) noexcept :
+		allocator(std::move(other.allocator)),
+		buffer(std::exchange(other.buffer, nullptr)),
+		capacity(std::exchange(other.capacity, 0)),
+		used(std::exchange(other.used, 0)),
+		count(std::exchange(other.count, 0)),
+		trivial(std::exchange(other.trivial, true)) {
+	}
+
+	~event_arena() {
+		clear();
+		deallocate();
+	}
+
+	auto operator=(event_arena const&) -> event_arena& = delete;
+
+	auto operator=(event_arena&& other) noexcept -> event_arena& {
+		if (&other != this) {
+			clear();
+			deallocate();
+
+			if constexpr (block_traits::propagate_on_container_move_assignment::value) {
+				allocator = std::move(other.allocator);
+			}
+
+			buffer = std::exchange(other.buffer, nullptr);
+			capacity = std::exchange(other.capacity, 0);
+			used = std::exchange(other.used, 0);
+			count = std::exchange(other.count, 0);
+			trivial = std::exchange(other.trivial, true);
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Construct an event at the end of the queue
+	 *
+	 * @param target  The object the event will be published to, by calling target.publish(event)
+	 * @param args    The arguments to construct the event with
+	 */
+	template<typename EventT, typename TargetT, typename... ArgsT>
+	auto emplace(TargetT& target, ArgsT&&... args) -> void {
+		static_assert(std::is_nothrow_move_constructible_v<EventT>, "Events must be nothrow move constructible");
+		static_assert(alignof(EventT) <= alignof(std::max_align_t), "Events may not be over-aligned");
+
+		auto const header_pos = align_up(used, alignof(record_header));
+		auto const event_pos = align_up(header_pos + sizeof(record_header), alignof(EventT));
+		auto const end = align_up(event_pos + sizeof(EventT), alignof(record_header));
+
+		if (end > capacity) {
+			grow(end);
+		}
+
+		// Construct the event before the header, so that nothing is committed if the constructor throws
+		::new (static_cast<void*>(data() + event_pos)) EventT(std::forward<ArgsT>(args)...);
+		::new (static_cast<void*>(data() + header_pos)) record_header{
+			&ops_for<EventT, TargetT>,
+			std::addressof(target),
+			static_cast<uint32_t>(event_pos - header_pos),
+			static_cast<uint32_t>(end - header_pos)
+		};
+
+		used = end;
+		++count;
+		trivial = trivial && std::is_trivially_destructible_v<EventT>;
+	}
+
+	/// Publish every event to its target, in insertion order
+	auto publish_all() const -> void {
+		for_each_record([](record_header& header, std::byte* event) {
+			header.ops->publish(header.target, event);
+		});
+	}
+
+	/// Destroy all events. The buffer is kept for reuse.
+	auto clear() noexcept -> void {
+		if (!trivial) {
+			for_each_record([](record_header& header, std::byte* event) {
+				header.ops->destroy(event);
+			});
+		}
+
+		used = 0;
+		count = 0;
+		trivial = true;
+	}
+
+	/// Get the number of events in the queue
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		return count;
+	}
+
+	[[nodiscard]]
+	auto empty() const noexcept -> bool {
+		return count == 0;
+	}
+
+	/// Get the size of the buffer, in bytes
+	[[nodiscard]]
+	auto capacity_bytes() const noexcept -> size_t {
+		return capacity;
+	}
+
+private:
+	[[nodiscard]]
+	static constexpr auto align_up(size_t value, size_t alignment) noexcept -> size_t {
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	[[nodiscard]]
+	auto data() const noexcept -> std::byte* {
+		return reinterpret_cast<std::byte*>(buffer);  //NOLINT(*-reinterpret-cast)
+	}
+
+	template<typename FunctionT>
+	auto for_each_record(FunctionT&& func) const -> void {
+		for (size_t pos = 0; pos < used;) {
+			auto* const header = std::launder(reinterpret_cast<record_header*>(data() + pos));  //NOLINT(*-reinterpret-cast)
+			auto const next = header->next;
+
+			func(*header, data() + pos + header->event_offset);
+			pos += next;
+		}
+	}
+
+	// Move every record into a larger buffer. Record offsets are unchanged, and since both buffers are aligned to
+	// max_align_t, so is the alignment of every event.
+	auto grow(size_t required) -> void {
+		auto const new_capacity = align_up(std::max({required, capacity * 2, min_capacity}), sizeof(block));
+		auto* const new_buffer = block_traits::allocate(allocator, new_capacity / sizeof(block));
+		auto* const new_data = reinterpret_cast<std::byte*>(new_buffer);  //NOLINT(*-reinterpret-cast)
+
+		for_each_record([&](record_header& header, std::byte* event) {
+			auto const pos = static_cast<size_t>(reinterpret_cast<std::byte*>(&header) - data());  //NOLINT(*-reinterpret-cast)
+
+			::new (static_cast<void*>(new_data + pos)) record_header{header};
+			header.ops->relocate(new_data + pos + header.event_offset, event);
+		});
+
+		deallocate();
+		buffer = new_buffer;
+		capacity = new_capacity;
+	}
+
+	auto deallocate() noexcept -> void {
+		if (buffer) {
+			block_traits::deallocate(allocator, buffer, capacity / sizeof(block));
+			buffer = nullptr;
+			capacity = 0;
+		}
+	}
+
+	block_allocator_type allocator;
+
+	block* buffer = nullptr;
+	size_t capacity = 0;  //in bytes
+	size_t used = 0;      //in bytes
+	size_t count = 0;
+
+	// True while every queued event is trivially destructible, which allows clearing without walking the records
+	bool trivial = true;
+};
+
+}  //namespace events::detail
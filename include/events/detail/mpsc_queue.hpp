@@ -0,0 +1,251 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include <events/detail/epoch_readers.hpp>
+
+
+namespace events::detail {
+
+/**
+ * @brief An unbounded multi-producer, single-consumer queue made of linked fixed-size segments. Producers never
+ *        block each other: each claims a slot with a single atomic increment and publishes it with a store.
+ *
+ * @details The consumer takes events in the order their slots were claimed, and stops at the first slot whose event
+ *          is still being constructed. Only one thread may consume at a time. Segments that have been consumed are
+ *          freed once no producer can still be using them, which is tracked with @ref epoch_readers.
+ */
+template<typename EventT, typename AllocatorT = std::allocator<void>>
+class mpsc_queue {
+	static constexpr size_t segment_size = 64;
+
+	enum class slot_state : uint8_t {
+		empty,
+		ready,
+		abandoned  //the producer's event constructor threw
+	};
+
+	struct slot {
+		alignas(EventT) std::byte storage[sizeof(EventT)];  //NOLINT(*-avoid-c-arrays)
+		std::atomic<slot_state> state = slot_state::empty;
+
+		[[nodiscard]]
+		auto event() noexcept -> EventT* {
+			return std::launder(reinterpret_cast<EventT*>(storage));  //NOLINT(*-reinterpret-cast)
+		}
+	};
+
+	struct segment {
+		std::array<slot, segment_size> slots;
+		std::atomic<size_t> claimed = 0;
+		std::atomic<segment*> next = nullptr;
+	};
+
+	using alloc_traits = std::allocator_traits<AllocatorT>;
+	using segment_allocator_type = typename alloc_traits::template rebind_alloc<segment>;
+	using segment_alloc_traits = std::allocator_traits<segment_allocator_type>;
+
+	using retired_allocator_type = typename alloc_traits::template rebind_alloc<std::pair<segment*, unsigned>>;
+	using retired_container_type = std::vector<std::pair<segment*, unsigned>, retired_allocator_type>;
+
+public:
+	mpsc_queue() : mpsc_queue(AllocatorT{}) {
+	}
+
+	explicit mpsc_queue(AllocatorT const& alloc) : allocator(alloc), retired(alloc) {
+		head = new_segment();
+		tail.store(head, std::memory_order_relaxed);
+	}
+
+	mpsc_queue(mpsc_queue const&) = delete;
+	mpsc_queue(mpsc_queue&&) = delete;
+
+	~mpsc_queue() {
+		consume([](EventT&&) {});
+
+		for (auto* seg = head; seg;) {
+			delete_segment(std::exchange(seg, seg->next.load(std::memory_order_relaxed)));
+		}
+
+		for (auto [seg, phases] : retired) {
+			delete_segment(seg);
+		}
+	}
+
+	auto operator=(mpsc_queue const&) -> mpsc_queue& = delete;
+	auto operator=(mpsc_queue&&) -> mpsc_queue& = delete;
+
+	/// Enqueue an event. Safe to call from any number of threads, concurrently with the consumer.
+	template<typename... ArgsT>
+	auto emplace(ArgsT&&... args) -> void {
+		auto guard = epoch_readers::read_guard{producers};
+
+		auto& target = claim();
+
+		try {
+			::new (static_cast<void*>(target.storage)) EventT(std::forward<ArgsT>(args)...);
+		}
+		catch (...) {
+			target.state.store(slot_state::abandoned, std::memory_order_release);
+			throw;
+		}
+
+		target.state.store(slot_state::ready, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Pass each available event to a function, in enqueue order, and remove it from the queue. Must not be
+	 *        called concurrently with itself.
+	 *
+	 * @return The number of events consumed
+	 */
+	template<typename FunctionT>
+	auto consume(FunctionT&& function) -> size_t {
+		auto count = size_t{0};
+
+		while (true) {
+			if (read_index == segment_size) {
+				auto* const next = head->next.load(std::memory_order_acquire);
+				if (!next) {
+					break;
+				}
+
+				auto* const consumed = std::exchange(head, next);
+				read_index = 0;
+
+				// Producers that arrive later must not find the retired segment through the tail. If the exchange
+				// fails, the tail has already moved past it.
+				auto expected = consumed;
+				tail.compare_exchange_strong(expected, next, std::memory_order_seq_cst);
+				retired.emplace_back(consumed, 0);
+			}
+
+			auto& current = head->slots[read_index];
+			auto const state = current.state.load(std::memory_order_acquire);
+
+			if (state == slot_state::empty) {
+				break;
+			}
+
+			++read_index;
+
+			if (state == slot_state::ready) {
+				// The slot is consumed even if the function throws, since the event may have been moved from
+				auto* const event = current.event();
+				auto const destroy = destroy_on_exit{event};
+				++count;
+				function(std::move(*event));
+			}
+		}
+
+		reclaim();
+		return count;
+	}
+
+	/**
+	 * @brief Get the number of slots that have been claimed but not consumed. This includes events which are still
+	 *        being constructed, or whose constructor threw. Must not be called concurrently with consume().
+	 */
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		auto result = size_t{0};
+
+		for (auto const* seg = head; seg; seg = seg->next.load(std::memory_order_acquire)) {
+			result += std::min(seg->claimed.load(std::memory_order_relaxed), segment_size);
+		}
+
+		return result - read_index;
+	}
+
+private:
+	struct destroy_on_exit {
+		EventT* event;
+
+		~destroy_on_exit() {
+			std::destroy_at(event);
+		}
+	};
+
+	// Claim the next free slot, moving on to (and possibly creating) the next segment if the current one is full
+	auto claim() -> slot& {
+		// The tail is loaded after entering the read guard, and in the same total order as the consumer's update of it
+		auto* seg = tail.load(std::memory_order_seq_cst);
+
+		while (true) {
+			auto const index = seg->claimed.fetch_add(1, std::memory_order_relaxed);
+			if (index < segment_size) {
+				return seg->slots[index];
+			}
+
+			auto* next = seg->next.load(std::memory_order_acquire);
+
+			if (!next) {
+				auto* const fresh = new_segment();
+
+				if (seg->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel)) {
+					next = fresh;
+				}
+				else {
+					delete_segment(fresh);
+				}
+			}
+
+			// Failing means another producer already moved the tail forward, which is just as good
+			tail.compare_exchange_strong(seg, next, std::memory_order_seq_cst);
+			seg = tail.load(std::memory_order_seq_cst);
+		}
+	}
+
+	// Free consumed segments once every producer that could have loaded them has finished
+	auto reclaim() -> void {
+		if (retired.empty()) {
+			return;
+		}
+
+		auto const idle = producers.idle_phases();
+
+		std::erase_if(retired, [this, idle](auto& entry) {
+			entry.second |= idle;
+
+			if (entry.second == epoch_readers::all_phases) {
+				delete_segment(entry.first);
+				return true;
+			}
+			return false;
+		});
+	}
+
+	[[nodiscard]]
+	auto new_segment() -> segment* {
+		auto alloc = segment_allocator_type{allocator};
+		auto* const seg = segment_alloc_traits::allocate(alloc, 1);
+		return ::new (static_cast<void*>(seg)) segment;
+	}
+
+	auto delete_segment(segment* seg) noexcept -> void {
+		auto alloc = segment_allocator_type{allocator};
+		std::destroy_at(seg);
+		segment_alloc_traits::deallocate(alloc, seg, 1);
+	}
+
+	AllocatorT allocator;
+
+	// Consumer side
+	segment* head = nullptr;
+	size_t read_index = 0;
+	retired_container_type retired;
+
+	// Producer side
+	std::atomic<segment*> tail = nullptr;
+	epoch_readers producers;
+};
+
+}  //namespace events::detail
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+
+namespace events::detail {
+
+/**
+ * @brief The type a publish function takes a signal argument as. Reference arguments are passed through unchanged,
+ *        and value arguments are taken by const reference, so that publishing never copies an argument before it
+ *        reaches the callbacks. Every callback receives the same const lvalue.
+ */
+template<typename T>
+using publish_arg_t = std::conditional_t<std::is_reference_v<T>, T, T const&>;
+
+/**
+ * @brief The signature a signal's callbacks are stored as. Every value argument is received by const reference, so
+ *        a callback wrapper doesn't copy an argument for each callback it forwards it to.
+ */
+template<typename FunctionT>
+struct publish_signature;
+
+template<typename ReturnT, typename... ArgsT>
+struct publish_signature<ReturnT(ArgsT...)> {
+	using type = ReturnT(publish_arg_t<ArgsT>...);
+};
+
+/**
+ * @brief Rebind a callback wrapper such as std::function or @ref small_function to the publish signature of the
+ *        function type it wraps. Wrappers that aren't templated on a function type are used unchanged.
+ */
+template<typename CallbackT>
+struct publish_callback {
+	using type = CallbackT;
+};
+
+template<template<typename> typename WrapperT, typename ReturnT, typename... ArgsT>
+struct publish_callback<WrapperT<ReturnT(ArgsT...)>> {
+	using type = WrapperT<typename publish_signature<ReturnT(ArgsT...)>::type>;
+};
+
+template<template<typename, size_t> typename WrapperT, typename ReturnT, typename... ArgsT, size_t BufferSize>
+struct publish_callback<WrapperT<ReturnT(ArgsT...), BufferSize>> {
+	using type = WrapperT<typename publish_signature<ReturnT(ArgsT...)>::type, BufferSize>;
+};
+
+template<typename CallbackT>
+using publish_callback_t = typename publish_callback<CallbackT>::type;
+
+}  //namespace events::detail
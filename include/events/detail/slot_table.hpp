@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace events::detail {
+
+/// A generation-checked key referring to an entry in a @ref slot_table
+struct slot_key {
+	uint32_t index = 0;
+	uint32_t generation = 0;
+};
+
+
+/**
+ * @brief Maps generation-checked keys to values. Each key refers to a slot, and carries the generation of the slot at
+ *        the time it was created. Slots are recycled once erased, but a recycled slot gets a new generation, so a key
+ *        that outlived its entry is detected in O(1) instead of referring to whatever replaced it.
+ *
+ * @details Generations are drawn from a counter that is never reset, so clearing or moving from a table doesn't allow
+ *          old keys to match new entries. Assigning to a table assigns new generations to the copied slots, so that
+ *          keys issued by either table before the assignment are no longer valid.
+ */
+template<typename ValueT, typename AllocatorT = std::allocator<void>>
+class slot_table {
+	static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+	struct slot {
+		ValueT value;
+		uint32_t generation;
+		uint32_t next_free;
+	};
+
+	using slot_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<slot>;
+	using slot_container_type = std::vector<slot, slot_allocator_type>;
+
+public:
+	slot_table() = default;
+
+	explicit slot_table(AllocatorT const& alloc) : slots(alloc) {
+	}
+
+	slot_table(slot_table const&) = default;
+
+	slot_table(slot_table const& other, AllocatorT const& alloc) :
+		slots(other.slots, alloc),
+		free_slot(other.free_slot),
+		next_generation(other.next_generation) {
+	}
+
+	slot_table(slot_table&& other) noexcept :
+		slots(std::move(other.slots)),
+		free_slot(std::exchange(other.free_slot, npos)),
+		next_generation(other.next_generation) {
+	}
+
+	slot_table(slot_table&& other, AllocatorT const& alloc) :
+		slots(std::move(other.slots), alloc),
+		free_slot(std::exchange(other.free_slot, npos)),
+		next_generation(other.next_generation) {
+	}
+
+	~slot_table() = default;
+
+	auto operator=(slot_table const& other) -> slot_table& {
+		if (&other != this) {
+			slots = other.slots;
+			free_slot = other.free_slot;
+			renew_generations(other.next_generation);
+		}
+		return *this;
+	}
+
+	auto operator=(slot_table&& other) noexcept -> slot_table& {
+		if (&other != this) {
+			slots = std::move(other.slots);
+			free_slot = std::exchange(other.free_slot, npos);
+			renew_generations(other.next_generation);
+		}
+		return *this;
+	}
+
+	/// Insert a value, returning a key that refers to it
+	auto insert(ValueT value) -> slot_key {
+		auto const generation = next_generation++;
+
+		if (free_slot != npos) {
+			auto const index = free_slot;
+			auto& entry = slots[index];
+
+			free_slot = entry.next_free;
+			entry = slot{std::move(value), generation, npos};
+
+			return slot_key{index, generation};
+		}
+
+		auto const index = static_cast<uint32_t>(slots.size());
+		slots.push_back(slot{std::move(value), generation, npos});
+
+		return slot_key{index, generation};
+	}
+
+	/// Get a pointer to the value a key refers to, or nullptr if the key is no longer valid
+	[[nodiscard]]
+	auto find(slot_key key) noexcept -> ValueT* {
+		if (key.index < slots.size() && slots[key.index].generation == key.generation) {
+			return &slots[key.index].value;
+		}
+		return nullptr;
+	}
+
+	/// Erase the value a key refers to. The key must be valid.
+	auto erase(slot_key key) -> void {
+		auto& entry = slots[key.index];
+
+		// Giving the slot an unused generation invalidates any outstanding keys to it
+		entry.generation = next_generation++;
+		entry.next_free = free_slot;
+		free_slot = key.index;
+	}
+
+	/// Access the value in a slot by index, regardless of generation
+	[[nodiscard]]
+	auto operator[](uint32_t index) noexcept -> ValueT& {
+		return slots[index].value;
+	}
+
+	auto reserve(size_t count) -> void {
+		slots.reserve(count);
+	}
+
+	/// Erase all values, invalidating all keys
+	auto clear() noexcept -> void {
+		slots.clear();
+		free_slot = npos;
+	}
+
+private:
+	// Give every slot a generation newer than any key issued by this table or by the table its slots came from
+	auto renew_generations(uint32_t other_next_generation) noexcept -> void {
+		next_generation = std::max(next_generation, other_next_generation);
+
+		for (auto& entry : slots) {
+			entry.generation = next_generation++;
+		}
+	}
+
+	slot_container_type slots;
+	uint32_t free_slot = npos;
+	uint32_t next_generation = 0;
+};
+
+}  //namespace events::detail
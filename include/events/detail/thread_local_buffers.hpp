@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+namespace events::detail {
+
+/**
+ * @brief A set of per-thread event buffers. Each producer thread appends to its own buffer, and a single consumer
+ *        collects the events of every buffer.
+ *
+ * @details A thread's buffer is created and registered the first time it enqueues to a given instance, and is
+ *          afterwards found through a thread-local table without touching any shared state. Each buffer has its own
+ *          mutex, which is only contended while the consumer collects it, and is aligned to a cache line, so producers
+ *          on different threads never write to the same cache line.
+ *
+ *          Events keep their order per producer thread, but not across threads. When a thread exits, its buffer stays
+ *          registered until its remaining events have been collected. When the instance is destroyed, the buffers of
+ *          threads which are still running are emptied and released the next time those threads register a buffer.
+ *
+ *          Buffers are allocated with the allocator of the instance. Their events are freed when the instance is
+ *          destroyed, but a buffer itself is freed by the last thread to release it, so the allocator must remain
+ *          usable until then.
+ */
+template<typename EventT, typename AllocatorT = std::allocator<void>>
+class thread_local_buffers {
+	using alloc_traits = std::allocator_traits<AllocatorT>;
+	using event_allocator_type = typename alloc_traits::template rebind_alloc<EventT>;
+
+	static constexpr size_t cache_line_size = 64;
+
+	struct alignas(cache_line_size) buffer {
+		explicit buffer(AllocatorT const& alloc) : events(alloc) {
+		}
+
+		std::mutex mut;
+		std::vector<EventT, event_allocator_type> events;
+
+		// Set when the owning instance is destroyed, after which the thread-local table may release the buffer
+		std::atomic<bool> closed = false;
+	};
+
+	using buffer_pointer = std::shared_ptr<buffer>;
+
+	using registry_allocator_type = typename alloc_traits::template rebind_alloc<buffer_pointer>;
+	using registry_type = std::vector<buffer_pointer, registry_allocator_type>;
+
+public:
+	thread_local_buffers() : thread_local_buffers(AllocatorT{}) {
+	}
+
+	explicit thread_local_buffers(AllocatorT const& alloc) : allocator(alloc), registry(alloc) {
+	}
+
+	thread_local_buffers(thread_local_buffers const&) = delete;
+	thread_local_buffers(thread_local_buffers&&) = delete;
+
+	~thread_local_buffers() {
+		auto lock = std::scoped_lock{registry_mut};
+
+		for (auto& buf : registry) {
+			auto buffer_lock = std::scoped_lock{buf->mut};
+
+			// Release the memory now, since the allocator may not outlive this instance
+			[[maybe_unused]] auto const discarded = std::move(buf->events);
+			buf->closed.store(true, std::memory_order_release);
+		}
+	}
+
+	auto operator=(thread_local_buffers const&) -> thread_local_buffers& = delete;
+	auto operator=(thread_local_buffers&&) -> thread_local_buffers& = delete;
+
+	/// Append an event to the calling thread's buffer. Safe to call from any number of threads.
+	template<typename... ArgsT>
+	auto emplace(ArgsT&&... args) -> void {
+		auto& buf = local_buffer();
+		auto lock = std::scoped_lock{buf.mut};
+		buf.events.emplace_back(std::forward<ArgsT>(args)...);
+	}
+
+	/**
+	 * @brief Pass each buffered event to a function and remove it from its buffer. Each thread's events are passed in
+	 *        the order they were enqueued. Must not be called concurrently with itself.
+	 *
+	 * @details Buffers whose thread has exited are unregistered once they have been emptied.
+	 *
+	 * @return The number of events consumed
+	 */
+	template<typename FunctionT>
+	auto consume(FunctionT&& function) -> size_t {
+		auto count = size_t{0};
+		auto lock = std::scoped_lock{registry_mut};
+
+		std::erase_if(registry, [&](buffer_pointer const& buf) {
+			auto buffer_lock = std::scoped_lock{buf->mut};
+
+			for (auto& event : buf->events) {
+				function(std::move(event));
+			}
+
+			count += buf->events.size();
+			buf->events.clear();
+
+			// Only the registry refers to the buffer once the thread-local table of its thread has been destroyed
+			return buf.use_count() == 1;
+		});
+
+		return count;
+	}
+
+	/// Get the number of buffered events in all threads
+	[[nodiscard]]
+	auto size() -> size_t {
+		auto result = size_t{0};
+		auto lock = std::scoped_lock{registry_mut};
+
+		for (auto const& buf : registry) {
+			auto buffer_lock = std::scoped_lock{buf->mut};
+			result += buf->events.size();
+		}
+
+		return result;
+	}
+
+private:
+	struct local_table {
+		std::unordered_map<uint64_t, buffer_pointer> buffers;
+
+		// The most recently used entry, which lets a thread enqueueing to one instance skip the table lookup
+		uint64_t cached_id = 0;
+		buffer* cached = nullptr;
+	};
+
+	// Find or register the calling thread's buffer for this instance
+	auto local_buffer() -> buffer& {
+		thread_local auto table = local_table{};
+
+		if (table.cached_id == id) {
+			return *table.cached;
+		}
+
+		auto& entry = table.buffers[id];
+
+		if (!entry) {
+			// Drop the buffers of instances that have been destroyed
+			std::erase_if(table.buffers, [](auto const& item) {
+				return item.second && item.second->closed.load(std::memory_order_acquire);
+			});
+
+			auto buf = std::allocate_shared<buffer>(allocator, allocator);
+			{
+				auto lock = std::scoped_lock{registry_mut};
+				registry.push_back(buf);
+			}
+			entry = std::move(buf);
+		}
+
+		table.cached_id = id;
+		table.cached = entry.get();
+		return *entry;
+	}
+
+	// Identifies this instance in the thread-local tables. Unlike the address, it is never reused.
+	static inline auto next_id = std::atomic<uint64_t>{1};
+	uint64_t const id = next_id.fetch_add(1, std::memory_order_relaxed);
+
+	AllocatorT allocator;
+
+	registry_type registry;
+	std::mutex registry_mut;
+};
+
+}  //namespace events::detail
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace events::detail {
+
+inline auto next_type_id() noexcept -> size_t {
+	static auto counter = std::atomic<size_t>{0};
+	return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/**
+ * @brief Get a dense integer ID for a type. IDs are assigned on first use, starting from 0, so they can be used to
+ *        index a flat array instead of looking types up in a map.
+ *
+ * @details IDs are only unique within a process, and are not stable between runs. If this header is used from
+ *          several shared libraries which don't export their symbols, each library may assign its own IDs.
+ */
+template<typename T>
+[[nodiscard]]
+auto type_id() noexcept -> size_t {
+	static auto const id = next_type_id();
+	return id;
+}
+
+}  //namespace events::detail
@@ -1,15 +1,14 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <concepts>
-#include <map>
 #include <memory>
 #include <numeric>
 #include <ranges>
 #include <shared_mutex>
 #include <span>
-#include <typeinfo>
-#include <typeindex>
 #include <type_traits>
 #include <vector>
 
@@ -17,7 +16,14 @@
 #include <boost/asio/experimental/parallel_group.hpp>
 
 #include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/dispatch_budget.hpp>
+#include <events/detail/concurrent_dispatcher_table.hpp>
+#include <events/detail/double_buffered_queue.hpp>
+#include <events/detail/type_id.hpp>
+#include <events/dispatcher/event_channel.hpp>
 #include <events/signal_handler/async_signal_handler.hpp>
+#include <events/signal_handler/synchronized_signal_handler.hpp>
 
 
 // NOLINTBEGIN(cppcoreguidelines-prefer-member-initializer,hicpp-noexcept-move,performance-noexcept-move-constructor)
@@ -46,10 +52,12 @@ public:
 	auto operator=(async_discrete_event_dispatcher&&) noexcept -> async_discrete_event_dispatcher& = default;
 
 	virtual auto dispatch() -> void = 0;
+	virtual auto dispatch(dispatch_budget& budget) -> void = 0;
 	virtual auto async_dispatch() -> void = 0;
 	virtual auto async_dispatch(boost::asio::any_completion_handler<void()> handler) -> void = 0;
 	virtual auto clear() -> void = 0;
 	virtual auto size() -> size_t = 0;
+	virtual auto dropped() -> size_t = 0;
 };
 
 
@@ -59,31 +67,41 @@ class [[nodiscard]] async_discrete_event_dispatcher final
 
 	using signal_handler_type = async_signal_handler<void(EventT), ExecutorT, AllocatorT>;
 
-	using event_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<EventT>;
-	using event_container_type = std::vector<EventT, event_allocator_type>;
+	using event_queue_type = double_buffered_queue<EventT, AllocatorT>;
 
 public:
+	using event_type = EventT;
+
 	explicit async_discrete_event_dispatcher(ExecutorT const& exec) :
 	    handler(exec) {
 	}
 
 	async_discrete_event_dispatcher(ExecutorT const& exec, AllocatorT const& allocator) :
 		handler(exec, allocator),
+		batch_handler(allocator),
 		events(allocator) {
 	}
 
+	async_discrete_event_dispatcher(ExecutorT const& exec, shrink_policy policy, AllocatorT const& allocator) :
+		handler(exec, allocator),
+		batch_handler(allocator),
+		events(policy, allocator) {
+	}
+
 	async_discrete_event_dispatcher(async_discrete_event_dispatcher const&) = delete;
 
 	async_discrete_event_dispatcher(async_discrete_event_dispatcher&& other) {
 		auto lock = std::scoped_lock{other.events_mut};
 		handler = std::move(other.handler);
+		batch_handler = std::move(other.batch_handler);
 		events = std::move(other.events);
 	}
 
 	async_discrete_event_dispatcher(async_discrete_event_dispatcher&& other, AllocatorT const& alloc) {
 		auto lock = std::scoped_lock{other.events_mut};
 		handler = decltype(handler){std::move(other.handler), alloc};
-		events = event_container_type{std::move(other.events), alloc};
+		batch_handler = decltype(batch_handler){std::move(other.batch_handler), alloc};
+		events = event_queue_type{std::move(other.events), alloc};
 	}
 
 	~async_discrete_event_dispatcher() override = default;
@@ -97,6 +115,7 @@ public:
 
 		auto lock = std::scoped_lock{events_mut, other.events_mut};
 		handler = std::move(other.handler);
+		batch_handler = std::move(other.batch_handler);
 		events = std::move(other.events);
 
 		return *this;
@@ -107,25 +126,64 @@ public:
 		return handler.connect(std::forward<FunctionT>(callback));
 	}
 
+	template<auto Candidate, typename ObjectT>
+	auto connect(ObjectT* instance) -> connection {
+		return handler.template connect<Candidate>(instance);
+	}
+
+	template<auto Candidate>
+	auto connect() -> connection {
+		return handler.template connect<Candidate>();
+	}
+
+	template<std::invocable<std::span<EventT const>> FunctionT>
+	auto connect_batch(FunctionT&& callback) -> connection {
+		return batch_handler.connect(std::forward<FunctionT>(callback));
+	}
+
 	auto dispatch() -> void override {
+		// Publishing from the front buffer allows events to be enqueued during iteration
 		auto lock = std::unique_lock{events_mut};
-		auto to_publish = std::move(events);
-		events.clear();
+		auto to_publish = events.acquire();
 		lock.unlock();
 
-		for (auto&& event : to_publish) {
-			handler.publish(std::move(event));
+		publish_all(to_publish.events());
+	}
+
+	auto dispatch(dispatch_budget& budget) -> void override {
+		auto lock = std::unique_lock{events_mut};
+		auto to_publish = events.resume();
+		lock.unlock();
+
+		auto count = size_t{0};
+
+		if (batch_handler.size() == 0) {
+			for (auto&& event : to_publish) {
+				if (!budget.take()) {
+					break;
+				}
+				handler.publish(std::move(event));
+				++count;
+			}
+		}
+		else {
+			// Batch listeners receive all of the events at once, so the budget is claimed before publishing
+			count = budget.take(to_publish.events().size());
+			publish_all(to_publish.events().first(count));
 		}
+
+		to_publish.keep_after(count);
 	}
 
 	auto async_dispatch() -> void override {
-		// Moving the vector and iterating over a local one allows events to be enqueued during iteration. Storing the
-		// vector in a shared_ptr allows the vector to be kept alive until all of the callbacks have completed.
+		// Each event is moved into the arguments shared by its callbacks, so the batch can be released as soon as all
+		// callbacks have been posted. Batch listeners can't be deferred, since they refer to the batch itself.
 		auto lock = std::unique_lock{events_mut};
-		auto to_publish = std::move(events);
-		events.clear();
+		auto to_publish = events.acquire();
 		lock.unlock();
 
+		batch_handler.publish(to_publish.events());
+
 		for (auto&& event : to_publish) {
 			handler.async_publish(std::move(event));
 		}
@@ -133,14 +191,15 @@ public:
 
 	auto async_dispatch(boost::asio::any_completion_handler<void()> completion) -> void override {
 		auto lock = std::unique_lock{events_mut};
-		auto to_publish = std::move(events);
-		events.clear();
+		auto to_publish = events.acquire();
 		lock.unlock();
 
-		return parallel_publish(std::move(to_publish), std::move(completion));
+		batch_handler.publish(to_publish.events());
+		return parallel_publish(to_publish.events(), std::move(completion));
 	}
 
 	auto send(EventT const& event) -> void {
+		batch_handler.publish(std::span{&event, 1});
 		handler.publish(event);
 	}
 
@@ -148,7 +207,7 @@ public:
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
 	auto send(RangeT const& range) -> void {
 		for (auto&& event : range) {
-			handler.publish(event);
+			send(event);
 		}
 	}
 
@@ -169,16 +228,27 @@ public:
 
 	template<typename... ArgsT>
 	requires std::constructible_from<EventT, ArgsT...>
-	auto enqueue(ArgsT&&... args) -> void {
+	auto enqueue(ArgsT&&... args) -> bool {
 		auto lock = std::scoped_lock{events_mut};
-		events.emplace_back(std::forward<ArgsT>(args)...);
+		return events.emplace(std::forward<ArgsT>(args)...);
 	}
 
 	template<std::ranges::range RangeT>
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
-	auto enqueue(RangeT&& range) -> void {
+	auto enqueue(RangeT&& range) -> size_t {
+		auto lock = std::scoped_lock{events_mut};
+		return events.insert(std::forward<RangeT>(range));
+	}
+
+	template<typename KeyT, typename MergeT>
+	auto enqueue_coalesced(KeyT const& key, EventT&& event, MergeT& merge) -> bool {
 		auto lock = std::scoped_lock{events_mut};
-		events.insert(events.end(), std::ranges::begin(range), std::ranges::end(range));
+		return events.emplace_coalesced(key, std::move(event), merge);
+	}
+
+	auto set_capacity(size_t capacity, overflow_policy policy) -> void {
+		auto lock = std::scoped_lock{events_mut};
+		events.set_capacity(capacity, policy);
 	}
 
 	auto clear() -> void override {
@@ -190,6 +260,10 @@ public:
 		return events.size();
 	}
 
+	auto dropped() -> size_t override {
+		return events.dropped();
+	}
+
 private:
 	// Publish a set of events using a parallel_group with a single completion that is invoked when all callbacks finish
 	template<std::ranges::range Range, boost::asio::completion_token_for<void()> CompletionToken>
@@ -217,10 +291,20 @@ private:
 		);
 	}
 
+	// Batch listeners are invoked before the per-event listeners, which may move from the events
+	auto publish_all(std::span<EventT> to_publish) -> void {
+		batch_handler.publish(to_publish);
+
+		for (auto&& event : to_publish) {
+			handler.publish(std::move(event));
+		}
+	}
+
 
 	signal_handler_type handler;
+	synchronized_signal_handler<void(std::span<EventT const>), AllocatorT> batch_handler;
 
-	event_container_type events;
+	event_queue_type events;
 	std::mutex events_mut;
 };
 
@@ -240,9 +324,7 @@ class [[nodiscard]] async_event_dispatcher {
 	using generic_dispatcher = dispatcher_type<void>;
 	using generic_dispatcher_pointer = std::shared_ptr<generic_dispatcher>;
 
-	using dispatcher_map_element_type = std::pair<const std::type_index, generic_dispatcher_pointer>;
-	using dispatcher_allocator_type = typename alloc_traits::template rebind_alloc<dispatcher_map_element_type>;
-	using dispatcher_map_type = std::map<std::type_index, generic_dispatcher_pointer, std::less<>, dispatcher_allocator_type>;
+	using dispatcher_table_type = detail::concurrent_dispatcher_table<generic_dispatcher, AllocatorT>;
 
 public:
 	using allocator_type = AllocatorT;
@@ -267,6 +349,22 @@ public:
 		async_event_dispatcher(context.get_executor(), alloc) {
 	}
 
+	/**
+	 * @brief Construct a new async_event_dispatcher whose event queues release unused memory according to a shrink
+	 *        policy. By default, event queues keep their largest capacity.
+	 */
+	async_event_dispatcher(ExecutorT const& exec, shrink_policy policy, AllocatorT const& alloc = AllocatorT{}) :
+		allocator(alloc),
+		executor(exec),
+		queue_policy(policy) {
+	}
+
+	template<typename ExecutionContext>
+	requires std::convertible_to<ExecutionContext&, boost::asio::execution_context&>
+	async_event_dispatcher(ExecutionContext& context, shrink_policy policy, AllocatorT const& alloc = AllocatorT{}) :
+		async_event_dispatcher(context.get_executor(), policy, alloc) {
+	}
+
 	async_event_dispatcher(async_event_dispatcher const&) = delete;
 
 	/**
@@ -284,6 +382,7 @@ public:
 		}
 
 		executor = std::move(other.executor);
+		queue_policy = other.queue_policy;
 		dispatchers = std::move(other.dispatchers);
 	}
 
@@ -302,7 +401,8 @@ public:
 		}
 
 		executor = std::move(other.executor);
-		dispatchers = dispatcher_map_type{std::move(other.dispatchers), alloc};
+		queue_policy = other.queue_policy;
+		dispatchers = dispatcher_table_type{std::move(other.dispatchers), alloc};
 	}
 
 	~async_event_dispatcher() = default;
@@ -314,7 +414,9 @@ public:
 	 *
 	 * @details Existing connection objects from this event dispatcher are invalidated. Existing connection objects
 	 *          from the other event dispatcher are NOT invalidated, and will now refer to this event dispatcher.
-	 *          Moving to and from an event dispatcher that has running callbacks is allowed.
+	 *          Moving to and from an event dispatcher that has running callbacks is allowed, but event types are looked
+	 *          up without locking, and this event dispatcher's per-type dispatchers are destroyed by the move, so other
+	 *          threads must not use this event dispatcher during the move.
 	 */
 	auto operator=(async_event_dispatcher&& other) -> async_event_dispatcher& {
 		if (&other == this) {
@@ -328,6 +430,7 @@ public:
 		}
 
 		executor = std::move(other.executor);
+		queue_policy = other.queue_policy;
 		dispatchers = std::move(other.dispatchers);
 
 		return *this;
@@ -358,17 +461,76 @@ public:
 		return get_or_create_dispatcher<EventT>().connect(std::forward<FunctionT>(callback));
 	}
 
+	/**
+	 * @brief Register a member function that will be invoked on an object when an event is published. The event type
+	 *        is deduced from the member function's parameter.
+	 *
+	 * @details The callback holds nothing but the object pointer, so it fits in the inline buffer of std::function
+	 *          or @ref small_function and connecting doesn't allocate. It is still invoked through the callback
+	 *          wrapper, like any other callback. The object must outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, detail::delegate_event_t<Candidate> const&>
+	auto connect(ObjectT* instance) -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_dispatcher<event_type>().template connect<Candidate>(instance);
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when an event is published. The event type is deduced
+	 *        from the function's parameter.
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), detail::delegate_event_t<Candidate> const&>
+	auto connect() -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_dispatcher<event_type>().template connect<Candidate>();
+	}
+
+	/**
+	 * @brief Register a callback function that will be invoked once per dispatch with all of the dispatched events of
+	 *        the specified type, as a contiguous span, instead of once per event
+	 *
+	 * @details Batch listeners are invoked before the per-event listeners of the same events. They are always invoked
+	 *          synchronously, on the thread which dispatches, since the span is only valid for the duration of the
+	 *          dispatch. Events which are sent immediately with send() are passed to batch listeners as a span of one
+	 *          event, but async_send() does not invoke batch listeners.
+	 *
+	 * @tparam EventT  The type of event this callback handles
+	 * @tparam FunctionT
+	 *
+	 * @param callback  A function which accepts one argument of type std::span<EventT const>
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<typename EventT, std::invocable<std::span<EventT const>> FunctionT>
+	auto connect_batch(FunctionT&& callback) -> connection {
+		return get_or_create_dispatcher<EventT>().connect_batch(std::forward<FunctionT>(callback));
+	}
+
 	/**
 	 * @brief Enqueue an event to be dispatched later
 	 *
 	 * @tparam EventT  The type of event to enqueue
 	 *
 	 * @param event  An instance of the event to enqueue
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
 	 */
 	template<typename EventT>
-	auto enqueue(EventT&& event) -> void {
+	auto enqueue(EventT&& event) -> bool {
 		using event_type = std::remove_cvref_t<EventT>;
-		get_or_create_dispatcher<event_type>().enqueue(std::forward<EventT>(event));
+		return get_or_create_dispatcher<event_type>().enqueue(std::forward<EventT>(event));
 	}
 
 	/**
@@ -378,11 +540,13 @@ public:
 	 * @tparam ArgsT
 	 *
 	 * @param args The arguments requires to construct an instance of this event
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
 	 */
 	template<typename EventT, typename... ArgsT>
 	requires std::constructible_from<EventT, ArgsT...>
-	auto enqueue(ArgsT&&... args) -> void {
-		get_or_create_dispatcher<EventT>().enqueue(std::forward<ArgsT>(args)...);
+	auto enqueue(ArgsT&&... args) -> bool {
+		return get_or_create_dispatcher<EventT>().enqueue(std::forward<ArgsT>(args)...);
 	}
 
 	/**
@@ -392,11 +556,34 @@ public:
 	 * @tparam RangeT
 	 *
 	 * @param range  The range of events to enqueue
+	 *
+	 * @return The number of events that were enqueued
 	 */
 	template<typename EventT, std::ranges::range RangeT>
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
-	auto enqueue(RangeT&& range) -> void {
-		get_or_create_dispatcher<EventT>().enqueue(std::forward<RangeT>(range));
+	auto enqueue(RangeT&& range) -> size_t {
+		return get_or_create_dispatcher<EventT>().enqueue(std::forward<RangeT>(range));
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later, or merge it into a pending event with the same key. A merged
+	 *        event keeps the position of the pending event, so only the latest state per key is dispatched.
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam KeyT
+	 * @tparam MergeT
+	 *
+	 * @param key    The key that identifies which events are coalesced. Must be hashable with std::hash.
+	 * @param event  An instance of the event to enqueue
+	 * @param merge  A function which accepts the pending event by reference and the new event by rvalue reference,
+	 *               and updates the pending event. By default, the pending event is replaced.
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
+	 */
+	template<typename EventT, typename KeyT, typename MergeT = detail::replace_event>
+	requires std::invocable<MergeT&, EventT&, EventT&&>
+	auto enqueue_coalesced(KeyT const& key, EventT event, MergeT merge = {}) -> bool {
+		return get_or_create_dispatcher<EventT>().enqueue_coalesced(key, std::move(event), merge);
 	}
 
 	/**
@@ -475,18 +662,65 @@ public:
 		);
 	}
 
+	/**
+	 * @brief Get a channel for an event type. A channel can enqueue and send events of that type without looking up
+	 *        the event type or locking the dispatcher map on every call.
+	 *
+	 * @tparam EventT  The type of event the channel handles
+	 *
+	 * @return A channel that is valid for the lifetime of this event dispatcher, including after it is moved
+	 */
+	template<typename EventT>
+	[[nodiscard]]
+	auto channel() -> event_channel<dispatcher_type<EventT>> {
+		return event_channel{get_or_create_dispatcher<EventT>()};
+	}
+
 	/// Dispatch all events in the queue synchronously
 	auto dispatch() -> void {
 		auto lock = std::shared_lock{dispatcher_mut};
-		for (auto& [type, dispatcher] : dispatchers) {
+		for (auto const& dispatcher : dispatchers) {
 			dispatcher->dispatch();
 		}
 	}
 
+	/**
+	 * @brief Synchronously dispatch at most a number of enqueued events. Events that don't fit in the budget stay in
+	 *        the queue, in order, and are dispatched first by the next call. Each call starts with the event type after
+	 *        the one where the previous call ran out, so that a busy event type can't starve the others.
+	 *
+	 * @param max_events  The maximum number of events to dispatch
+	 *
+	 * @return The number of events dispatched
+	 */
+	auto dispatch_n(size_t max_events) -> size_t {
+		auto budget = detail::dispatch_budget{max_events};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
+	/**
+	 * @brief Synchronously dispatch enqueued events until a time budget runs out. The budget is checked before each
+	 *        event, so a slow callback can overrun it. Events that weren't dispatched are resumed by the next call,
+	 *        like @ref dispatch_n.
+	 *
+	 * @param duration  The time budget
+	 *
+	 * @return The number of events dispatched
+	 */
+	template<typename RepT, typename PeriodT>
+	auto dispatch_for(std::chrono::duration<RepT, PeriodT> duration) -> size_t {
+		using clock_type = detail::dispatch_budget::clock_type;
+
+		auto budget = detail::dispatch_budget{clock_type::now() + std::chrono::ceil<clock_type::duration>(duration)};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
 	/// Dispatch all events in the queue asynchronously
 	auto async_dispatch() -> void {
 		auto lock = std::shared_lock{dispatcher_mut};
-		for (auto& [type, dispatcher] : dispatchers) {
+		for (auto const& dispatcher : dispatchers) {
 			dispatcher->async_dispatch();
 		}
 	}
@@ -519,7 +753,7 @@ public:
 		auto operations = std::vector<op_type>{};
 		operations.reserve(dispatchers.size());
 
-		for (auto& [type, dispatcher] : dispatchers) {
+		for (auto const& dispatcher : dispatchers) {
 			operations.emplace_back(initiate(*dispatcher));
 		}
 
@@ -531,6 +765,20 @@ public:
 		);
 	}
 
+	/**
+	 * @brief Limit the number of pending events of a specific type. Events which are already pending are kept, even
+	 *        if there are more than the new capacity.
+	 *
+	 * @tparam EventT  The type of event to limit
+	 *
+	 * @param capacity  The maximum number of pending events, or 0 for no limit
+	 * @param policy    What to do with an event that is enqueued while the queue is full
+	 */
+	template<typename EventT>
+	auto set_queue_capacity(size_t capacity, overflow_policy policy = overflow_policy::drop_newest) -> void {
+		get_or_create_dispatcher<EventT>().set_capacity(capacity, policy);
+	}
+
 	/**
 	 * @brief Get the number of enqueued events for a specific event type or for all events
 	 *
@@ -545,53 +793,91 @@ public:
 		auto lock = std::scoped_lock{dispatcher_mut};
 
 		if constexpr (std::same_as<void, EventT>) {
-			auto sizes = std::views::values(dispatchers) | std::views::transform([](auto const& ptr) { return ptr->size(); });
+			auto sizes = dispatchers | std::views::transform([](auto const& ptr) { return ptr->size(); });
 			return std::accumulate(std::ranges::begin(sizes), std::ranges::end(sizes), 0ull);
 		}
 
-		auto const key = std::type_index{typeid(EventT)};
+		if (auto* const dispatcher = dispatchers.find(detail::type_id<EventT>())) {
+			return dispatcher->size();
+		}
+
+		return 0;
+	}
 
-		if (auto it = dispatchers.find(key); it != dispatchers.end()) {
-			return it->second->size();
+	/**
+	 * @brief Get the number of events that were discarded because their queue was full, for a specific event type or
+	 *        for all events
+	 *
+	 * @tparam EventT  The type of event to get the count of. Leave default (void) to obtain the total number of
+	 *                 dropped events.
+	 *
+	 * @return The number of dropped events
+	 */
+	template<typename EventT = void>
+	[[nodiscard]]
+	auto dropped_count() const -> size_t {
+		auto lock = std::scoped_lock{dispatcher_mut};
+
+		if constexpr (std::same_as<void, EventT>) {
+			auto counts = dispatchers | std::views::transform([](auto const& ptr) { return ptr->dropped(); });
+			return std::accumulate(std::ranges::begin(counts), std::ranges::end(counts), 0ull);
+		}
+
+		if (auto* const dispatcher = dispatchers.find(detail::type_id<EventT>())) {
+			return dispatcher->dropped();
 		}
 
 		return 0;
 	}
 
 private:
-	template<typename EventT>
-	auto get_or_create_dispatcher() -> dispatcher_type<EventT>& {
-		auto const key = std::type_index{typeid(EventT)};
+	// Dispatch each event type in turn until the budget runs out, starting after the type where the last budgeted
+	// dispatch ran out
+	auto dispatch_budgeted(detail::dispatch_budget& budget) -> void {
+		auto lock = std::shared_lock{dispatcher_mut};
+		auto const count = dispatchers.size();
+		auto const start = next_dispatcher.load(std::memory_order_relaxed);
 
-		// Attempt to find an existing dispatcher
-		{
-			auto lock = std::shared_lock{dispatcher_mut};
+		for (size_t i = 0; i < count; ++i) {
+			auto const position = (start + i) % count;
+			dispatchers[position].dispatch(budget);
 
-			if (auto it = dispatchers.find(key); it != dispatchers.end()) {
-				return static_cast<dispatcher_type<EventT>&>(*(it->second));
+			if (budget.exhausted()) {
+				next_dispatcher.store((position + 1) % count, std::memory_order_relaxed);
+				break;
 			}
 		}
+	}
+
+	template<typename EventT>
+	auto get_or_create_dispatcher() -> dispatcher_type<EventT>& {
+		auto const id = detail::type_id<EventT>();
+
+		// Existing dispatchers are found without locking, since the table is insert-only
+		if (auto* const dispatcher = dispatchers.find(id)) {
+			return static_cast<dispatcher_type<EventT>&>(*dispatcher);
+		}
 
 		// If the dispatcher didn't exist, then acquire an exclusive lock and create it.
 		auto lock = std::unique_lock{dispatcher_mut};
 
-		auto const [iter, inserted] = dispatchers.try_emplace(key);
-
-		// Check if it actually was created since two threads could get to the point where they try
-		// to acquire an exclusive lock.
-		if (inserted) {
-			iter->second = std::allocate_shared<dispatcher_type<EventT>>(allocator, executor, allocator);
+		// Check again since two threads could get to the point where they try to acquire an exclusive lock.
+		if (auto* const dispatcher = dispatchers.find(id)) {
+			return static_cast<dispatcher_type<EventT>&>(*dispatcher);
 		}
 
-		return static_cast<dispatcher_type<EventT>&>(*(iter->second));
+		return static_cast<dispatcher_type<EventT>&>(dispatchers.insert(id, std::allocate_shared<dispatcher_type<EventT>>(allocator, executor, queue_policy, allocator)));
 	}
 
 	AllocatorT allocator;
 
 	ExecutorT executor;
 
-	dispatcher_map_type dispatchers{allocator};
+	shrink_policy queue_policy;
+
+	dispatcher_table_type dispatchers{allocator};
 	mutable std::shared_mutex dispatcher_mut;
+	std::atomic<size_t> next_dispatcher = 0;
 };
 
 }  //namespace events
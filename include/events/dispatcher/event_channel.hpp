@@ -0,0 +1,111 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <utility>
+
+#include <events/detail/coalescing_index.hpp>
+
+
+namespace events {
+
+/**
+ * @brief A handle bound directly to the queue and signal handler of a single event type in an event dispatcher.
+ *        Enqueueing or sending through a channel skips the event type lookup, and in the synchronized and async
+ *        dispatchers, the lock that guards it.
+ *
+ * @details Channels are obtained from an event dispatcher's channel() function, and are cheap to copy. A channel
+ *          remains valid when the event dispatcher it came from is moved, except for a @ref
+ *          basic_static_event_dispatcher, and must not be used after that event dispatcher is destroyed.
+ *
+ * @tparam DispatcherT  The discrete dispatcher type that holds the events of this channel
+ */
+template<typename DispatcherT>
+class event_channel {
+public:
+	using event_type = typename DispatcherT::event_type;
+
+	explicit event_channel(DispatcherT& discrete_dispatcher) noexcept : dispatcher(&discrete_dispatcher) {
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later
+	 *
+	 * @param args The arguments required to construct an instance of this event
+	 *
+	 * @return False if the queue is full and the event was discarded
+	 */
+	template<typename... ArgsT>
+	requires std::constructible_from<event_type, ArgsT...>
+	auto enqueue(ArgsT&&... args) const -> bool {
+		return dispatcher->enqueue(std::forward<ArgsT>(args)...);
+	}
+
+	/**
+	 * @brief Enqueue a range of events to be dispatched later
+	 *
+	 * @param range The range of events to enqueue
+	 *
+	 * @return The number of events that were enqueued
+	 */
+	template<std::ranges::range RangeT>
+	requires std::convertible_to<std::ranges::range_value_t<RangeT>, event_type>
+	auto enqueue(RangeT&& range) const -> size_t {
+		return dispatcher->enqueue(std::forward<RangeT>(range));
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later, or merge it into a pending event with the same key
+	 *
+	 * @param key    The key that identifies which events are coalesced. Must be hashable with std::hash.
+	 * @param event  An instance of the event to enqueue
+	 * @param merge  A function which accepts the pending event by reference and the new event by rvalue reference,
+	 *               and updates the pending event. By default, the pending event is replaced.
+	 *
+	 * @return False if the queue is full and the event was discarded
+	 */
+	template<typename KeyT, typename MergeT = detail::replace_event>
+	requires std::invocable<MergeT&, event_type&, event_type&&>
+	auto enqueue_coalesced(KeyT const& key, event_type event, MergeT merge = {}) const -> bool {
+		return dispatcher->enqueue_coalesced(key, std::move(event), merge);
+	}
+
+	/**
+	 * @brief Send an event immediately
+	 *
+	 * @param event An instance of the event to send
+	 */
+	auto send(event_type const& event) const -> void {
+		dispatcher->send(event);
+	}
+
+	/**
+	 * @brief Send a range of events immediately
+	 *
+	 * @param range The range of events to send
+	 */
+	template<std::ranges::range RangeT>
+	requires std::convertible_to<std::ranges::range_value_t<RangeT>, event_type>
+	auto send(RangeT&& range) const -> void {
+		dispatcher->send(std::forward<RangeT>(range));
+	}
+
+	/// Send an event or range of events asynchronously. Only available for channels of an async_event_dispatcher.
+	template<typename... ArgsT>
+	requires requires(DispatcherT& d, ArgsT&&... args) { d.async_send(std::forward<ArgsT>(args)...); }
+	auto async_send(ArgsT&&... args) const {
+		return dispatcher->async_send(std::forward<ArgsT>(args)...);
+	}
+
+	/// Get the number of enqueued events
+	[[nodiscard]]
+	auto size() const -> size_t {
+		return dispatcher->size();
+	}
+
+private:
+	DispatcherT* dispatcher;
+};
+
+}  //namespace events
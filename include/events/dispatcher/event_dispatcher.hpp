@@ -1,16 +1,22 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <concepts>
-#include <map>
 #include <memory>
 #include <numeric>
 #include <ranges>
-#include <typeinfo>
-#include <typeindex>
-#include <vector>
+#include <span>
+#include <utility>
 
 #include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/dispatch_budget.hpp>
+#include <events/detail/dispatcher_table.hpp>
+#include <events/detail/double_buffered_queue.hpp>
+#include <events/detail/type_id.hpp>
+#include <events/dispatcher/event_channel.hpp>
+#include <events/frame_arena.hpp>
 #include <events/signal_handler/signal_handler.hpp>
 
 
@@ -34,20 +40,32 @@ public:
 	auto operator=(discrete_event_dispatcher&&) noexcept -> discrete_event_dispatcher& = default;
 
 	virtual auto dispatch() -> void = 0;
+	virtual auto dispatch(dispatch_budget& budget) -> void = 0;
 	virtual auto clear() -> void = 0;
-	virtual auto size() -> size_t = 0;
+	virtual auto size() const -> size_t = 0;
+	virtual auto dropped() const -> size_t = 0;
 };
 
 
 template<typename EventT, typename AllocatorT>
 class [[nodiscard]] discrete_event_dispatcher final : public discrete_event_dispatcher<void, AllocatorT> {
-	using event_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<EventT>;
-	using event_container_type = std::vector<EventT, event_allocator_type>;
+	using event_queue_type = double_buffered_queue<EventT, AllocatorT>;
 
 public:
+	using event_type = EventT;
+
 	discrete_event_dispatcher() = default;
 
-	explicit discrete_event_dispatcher(AllocatorT const& allocator) : handler(allocator), events(allocator) {
+	explicit discrete_event_dispatcher(AllocatorT const& allocator) :
+		handler(allocator),
+		batch_handler(allocator),
+		events(allocator) {
+	}
+
+	discrete_event_dispatcher(shrink_policy policy, AllocatorT const& allocator) :
+		handler(allocator),
+		batch_handler(allocator),
+		events(policy, allocator) {
 	}
 
 	discrete_event_dispatcher(discrete_event_dispatcher const&) = delete;
@@ -56,6 +74,7 @@ public:
 
 	discrete_event_dispatcher(discrete_event_dispatcher&& other, AllocatorT const& allocator) :
 		handler(std::move(other.handler), allocator),
+		batch_handler(std::move(other.batch_handler), allocator),
 		events(std::move(other.events), allocator) {
 	}
 
@@ -69,17 +88,51 @@ public:
 		return handler.connect(std::forward<FunctionT>(callback));
 	}
 
+	template<auto Candidate, typename ObjectT>
+	auto connect(ObjectT* instance) -> connection {
+		return handler.template connect<Candidate>(instance);
+	}
+
+	template<auto Candidate>
+	auto connect() -> connection {
+		return handler.template connect<Candidate>();
+	}
+
+	template<std::invocable<std::span<EventT const>> FunctionT>
+	auto connect_batch(FunctionT&& callback) -> connection {
+		return batch_handler.connect(std::forward<FunctionT>(callback));
+	}
+
 	auto dispatch() -> void override {
-		// Moving the vector and iterating over a local one allows events to be enqueued during iteration
-		auto to_publish = std::move(events);
-		events.clear();
+		// Publishing from the front buffer allows events to be enqueued during iteration
+		auto to_publish = events.acquire();
+		publish_all(to_publish.events());
+	}
 
-		for (auto const& event : to_publish) {
-			handler.publish(event);
+	auto dispatch(dispatch_budget& budget) -> void override {
+		auto to_publish = events.resume();
+		auto count = size_t{0};
+
+		if (batch_handler.size() == 0) {
+			for (auto const& event : to_publish) {
+				if (!budget.take()) {
+					break;
+				}
+				handler.publish(event);
+				++count;
+			}
+		}
+		else {
+			// Batch listeners receive all of the events at once, so the budget is claimed before publishing
+			count = budget.take(to_publish.events().size());
+			publish_all(to_publish.events().first(count));
 		}
+
+		to_publish.keep_after(count);
 	}
 
 	auto send(EventT const& event) -> void {
+		batch_handler.publish(std::span{&event, 1});
 		handler.publish(event);
 	}
 
@@ -87,33 +140,56 @@ public:
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
 	auto send(RangeT&& range) -> void {
 		for (auto&& event : range) {
-			handler.publish(event);
+			send(event);
 		}
 	}
 
 	template<typename... ArgsT>
 	requires std::constructible_from<EventT, ArgsT...>
-	auto enqueue(ArgsT&&... args) -> void {
-		events.emplace_back(std::forward<ArgsT>(args)...);
+	auto enqueue(ArgsT&&... args) -> bool {
+		return events.emplace(std::forward<ArgsT>(args)...);
 	}
 
 	template<std::ranges::range RangeT>
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
-	auto enqueue(RangeT&& range) -> void {
-		events.insert(events.end(), std::ranges::begin(range), std::ranges::end(range));
+	auto enqueue(RangeT&& range) -> size_t {
+		return events.insert(std::forward<RangeT>(range));
+	}
+
+	template<typename KeyT, typename MergeT>
+	auto enqueue_coalesced(KeyT const& key, EventT&& event, MergeT& merge) -> bool {
+		return events.emplace_coalesced(key, std::move(event), merge);
+	}
+
+	auto set_capacity(size_t capacity, overflow_policy policy) -> void {
+		events.set_capacity(capacity, policy);
 	}
 
 	auto clear() -> void override {
 		events.clear();
 	}
 
-	auto size() -> size_t override {
+	auto size() const -> size_t override {
 		return events.size();
 	}
 
+	auto dropped() const -> size_t override {
+		return events.dropped();
+	}
+
 private:
+	// Batch listeners are invoked before the per-event listeners
+	auto publish_all(std::span<EventT const> to_publish) -> void {
+		batch_handler.publish(to_publish);
+
+		for (auto const& event : to_publish) {
+			handler.publish(event);
+		}
+	}
+
 	signal_handler<void(EventT const&), AllocatorT> handler;
-	event_container_type events;
+	signal_handler<void(std::span<EventT const>), AllocatorT> batch_handler;
+	event_queue_type events;
 };
 
 }  //namespace detail
@@ -130,9 +206,7 @@ class [[nodiscard]] basic_event_dispatcher {
 	using generic_dispatcher = detail::discrete_event_dispatcher<void, AllocatorT>;
 	using generic_dispatcher_pointer = std::shared_ptr<generic_dispatcher>;
 
-	using dispatcher_map_element_type = std::pair<const std::type_index, generic_dispatcher_pointer>;
-	using dispatcher_allocator_type = typename alloc_traits::template rebind_alloc<dispatcher_map_element_type>;
-	using dispatcher_map_type = std::map<std::type_index, generic_dispatcher_pointer, std::less<>, dispatcher_allocator_type>;
+	using dispatcher_table_type = detail::dispatcher_table<generic_dispatcher, AllocatorT>;
 
 public:
 	using allocator_type = AllocatorT;
@@ -142,6 +216,27 @@ public:
 	explicit basic_event_dispatcher(AllocatorT const& alloc) : allocator(alloc) {
 	}
 
+	/**
+	 * @brief Construct a new basic_event_dispatcher whose event queues release unused memory according to a shrink
+	 *        policy. By default, event queues keep their largest capacity.
+	 */
+	explicit basic_event_dispatcher(shrink_policy policy, AllocatorT const& alloc = AllocatorT{}) :
+		allocator(alloc),
+		queue_policy(policy) {
+	}
+
+	/**
+	 * @brief Construct a new basic_event_dispatcher that starts a new frame of a @ref frame_arena on every dispatch.
+	 *        Events whose members were allocated from the arena are released wholesale once they are dispatched.
+	 *
+	 * @details The arena must outlive this event dispatcher, and must not be attached to any other event dispatcher.
+	 */
+	explicit basic_event_dispatcher(frame_arena& arena, shrink_policy policy = {}, AllocatorT const& alloc = AllocatorT{}) :
+		allocator(alloc),
+		queue_policy(policy),
+		frames(&arena) {
+	}
+
 	basic_event_dispatcher(basic_event_dispatcher const&) = delete;
 
 	/**
@@ -150,7 +245,9 @@ public:
 	 *
 	 * @details Existing connection objects from the other event dispatcher are NOT invalidated.
 	 */
-	basic_event_dispatcher(basic_event_dispatcher&& other) noexcept {
+	basic_event_dispatcher(basic_event_dispatcher&& other) noexcept :
+		queue_policy(other.queue_policy),
+		frames(std::exchange(other.frames, nullptr)) {
 		if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
 			allocator = std::move(other.allocator);
 		}
@@ -167,6 +264,8 @@ public:
 	 */
 	basic_event_dispatcher(basic_event_dispatcher&& other, AllocatorT const& alloc) noexcept :
 		allocator(alloc),
+		queue_policy(other.queue_policy),
+		frames(std::exchange(other.frames, nullptr)),
 		dispatchers(std::move(other.dispatchers), allocator) {
 	}
 
@@ -185,6 +284,8 @@ public:
 			allocator = std::move(other.allocator);
 		}
 
+		queue_policy = other.queue_policy;
+		frames = std::exchange(other.frames, nullptr);
 		dispatchers = std::move(other.dispatchers);
 
 		return *this;
@@ -210,17 +311,74 @@ public:
 		return get_or_create_dispatcher<EventT>().connect(std::forward<FunctionT>(callback));
 	}
 
+	/**
+	 * @brief Register a member function that will be invoked on an object when an event is published. The event type
+	 *        is deduced from the member function's parameter.
+	 *
+	 * @details The callback holds nothing but the object pointer, so it fits in the inline buffer of std::function
+	 *          or @ref small_function and connecting doesn't allocate. It is still invoked through the callback
+	 *          wrapper, like any other callback. The object must outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, detail::delegate_event_t<Candidate> const&>
+	auto connect(ObjectT* instance) -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_dispatcher<event_type>().template connect<Candidate>(instance);
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when an event is published. The event type is deduced
+	 *        from the function's parameter.
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), detail::delegate_event_t<Candidate> const&>
+	auto connect() -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_dispatcher<event_type>().template connect<Candidate>();
+	}
+
+	/**
+	 * @brief Register a callback function that will be invoked once per dispatch with all of the dispatched events of
+	 *        the specified type, as a contiguous span, instead of once per event
+	 *
+	 * @details Batch listeners are invoked before the per-event listeners of the same events. Events which are
+	 *          sent immediately are passed to batch listeners as a span of one event.
+	 *
+	 * @tparam EventT  The type of event this callback handles
+	 * @tparam FunctionT
+	 *
+	 * @param callback  A function which accepts one argument of type std::span<EventT const>
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<typename EventT, std::invocable<std::span<EventT const>> FunctionT>
+	auto connect_batch(FunctionT&& callback) -> connection {
+		return get_or_create_dispatcher<EventT>().connect_batch(std::forward<FunctionT>(callback));
+	}
+
 	/**
 	 * @brief Enqueue an event to be dispatched later
 	 *
 	 * @tparam EventT  The type of event to enqueue
 	 *
 	 * @param event  An instance of the event to enqueue
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
 	 */
 	template<typename EventT>
-	auto enqueue(EventT&& event) -> void {
+	auto enqueue(EventT&& event) -> bool {
 		using event_type = std::remove_cvref_t<EventT>;
-		get_or_create_dispatcher<event_type>().enqueue(std::forward<EventT>(event));
+		return get_or_create_dispatcher<event_type>().enqueue(std::forward<EventT>(event));
 	}
 
 	/**
@@ -230,11 +388,13 @@ public:
 	 * @tparam ArgsT
 	 *
 	 * @param args The arguments requires to construct an instance of this event
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
 	 */
 	template<typename EventT, typename... ArgsT>
 	requires std::constructible_from<EventT, ArgsT...>
-	auto enqueue(ArgsT&&... args) -> void {
-		get_or_create_dispatcher<EventT>().enqueue(std::forward<ArgsT>(args)...);
+	auto enqueue(ArgsT&&... args) -> bool {
+		return get_or_create_dispatcher<EventT>().enqueue(std::forward<ArgsT>(args)...);
 	}
 
 	/**
@@ -244,11 +404,34 @@ public:
 	 * @tparam RangeT
 	 *
 	 * @param args The range of events to enqueue
+	 *
+	 * @return The number of events that were enqueued
 	 */
 	template<typename EventT, std::ranges::range RangeT>
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
-	auto enqueue(RangeT&& range) -> void {
-		get_or_create_dispatcher<EventT>().enqueue(std::forward<RangeT>(range));
+	auto enqueue(RangeT&& range) -> size_t {
+		return get_or_create_dispatcher<EventT>().enqueue(std::forward<RangeT>(range));
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later, or merge it into a pending event with the same key. A merged
+	 *        event keeps the position of the pending event, so only the latest state per key is dispatched.
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam KeyT
+	 * @tparam MergeT
+	 *
+	 * @param key    The key that identifies which events are coalesced. Must be hashable with std::hash.
+	 * @param event  An instance of the event to enqueue
+	 * @param merge  A function which accepts the pending event by reference and the new event by rvalue reference,
+	 *               and updates the pending event. By default, the pending event is replaced.
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
+	 */
+	template<typename EventT, typename KeyT, typename MergeT = detail::replace_event>
+	requires std::invocable<MergeT&, EventT&, EventT&&>
+	auto enqueue_coalesced(KeyT const& key, EventT event, MergeT merge = {}) -> bool {
+		return get_or_create_dispatcher<EventT>().enqueue_coalesced(key, std::move(event), merge);
 	}
 
 	/**
@@ -292,13 +475,77 @@ public:
 		get_or_create_dispatcher<EventT>().send(std::forward<RangeT>(range));
 	}
 
+	/**
+	 * @brief Get a channel for an event type. A channel can enqueue and send events of that type without looking up
+	 *        the event type on every call.
+	 *
+	 * @tparam EventT  The type of event the channel handles
+	 *
+	 * @return A channel that is valid for the lifetime of this event dispatcher, including after it is moved
+	 */
+	template<typename EventT>
+	[[nodiscard]]
+	auto channel() -> event_channel<detail::discrete_event_dispatcher<EventT, AllocatorT>> {
+		return event_channel{get_or_create_dispatcher<EventT>()};
+	}
+
 	/// Dispatch all events in the queue
 	auto dispatch() -> void {
-		for (auto& [type, dispatcher] : dispatchers) {
-			dispatcher->dispatch();
+		auto const frame = detail::frame_scope{frames};
+
+		// Iterate by position, since a callback may add an event type to the table
+		for (size_t i = 0; i < dispatchers.size(); ++i) {
+			dispatchers[i].dispatch();
 		}
 	}
 
+	/**
+	 * @brief Dispatch at most a number of enqueued events. Events that don't fit in the budget stay in the queue, in
+	 *        order, and are dispatched first by the next call. Each call starts with the event type after the one
+	 *        where the previous call ran out, so that a busy event type can't starve the others.
+	 *
+	 * @param max_events  The maximum number of events to dispatch
+	 *
+	 * @return The number of events dispatched
+	 */
+	auto dispatch_n(size_t max_events) -> size_t {
+		auto budget = detail::dispatch_budget{max_events};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
+	/**
+	 * @brief Dispatch enqueued events until a time budget runs out. The budget is checked before each event, so a slow
+	 *        callback can overrun it. Events that weren't dispatched are resumed by the next call, like
+	 *        @ref dispatch_n.
+	 *
+	 * @param duration  The time budget
+	 *
+	 * @return The number of events dispatched
+	 */
+	template<typename RepT, typename PeriodT>
+	auto dispatch_for(std::chrono::duration<RepT, PeriodT> duration) -> size_t {
+		using clock_type = detail::dispatch_budget::clock_type;
+
+		auto budget = detail::dispatch_budget{clock_type::now() + std::chrono::ceil<clock_type::duration>(duration)};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
+	/**
+	 * @brief Limit the number of pending events of a specific type. Events which are already pending are kept, even
+	 *        if there are more than the new capacity.
+	 *
+	 * @tparam EventT  The type of event to limit
+	 *
+	 * @param capacity  The maximum number of pending events, or 0 for no limit
+	 * @param policy    What to do with an event that is enqueued while the queue is full
+	 */
+	template<typename EventT>
+	auto set_queue_capacity(size_t capacity, overflow_policy policy = overflow_policy::drop_newest) -> void {
+		get_or_create_dispatcher<EventT>().set_capacity(capacity, policy);
+	}
+
 	/**
 	 * @brief Get the number of enqueued events for a specific event type or for all events
 	 *
@@ -311,35 +558,78 @@ public:
 	[[nodiscard]]
 	auto queue_size() const -> size_t {
 		if constexpr (std::same_as<void, EventT>) {
-			auto sizes = std::views::values(dispatchers) | std::views::transform([](auto const& ptr) { return ptr->size(); });
+			auto sizes = dispatchers | std::views::transform([](auto const& ptr) { return ptr->size(); });
 			return std::accumulate(std::ranges::begin(sizes), std::ranges::end(sizes), 0ull);
 		}
 
-		auto const key = std::type_index{typeid(EventT)};
+		if (auto* const dispatcher = dispatchers.find(detail::type_id<EventT>())) {
+			return dispatcher->size();
+		}
 
-		if (auto it = dispatchers.find(key); it != dispatchers.end()) {
-			return it->second->size();
+		return 0;
+	}
+
+	/**
+	 * @brief Get the number of events that were discarded because their queue was full, for a specific event type or
+	 *        for all events
+	 *
+	 * @tparam EventT  The type of event to get the count of. Leave default (void) to obtain the total number of
+	 *                 dropped events.
+	 *
+	 * @return The number of dropped events
+	 */
+	template<typename EventT = void>
+	[[nodiscard]]
+	auto dropped_count() const -> size_t {
+		if constexpr (std::same_as<void, EventT>) {
+			auto counts = dispatchers | std::views::transform([](auto const& ptr) { return ptr->dropped(); });
+			return std::accumulate(std::ranges::begin(counts), std::ranges::end(counts), 0ull);
+		}
+
+		if (auto* const dispatcher = dispatchers.find(detail::type_id<EventT>())) {
+			return dispatcher->dropped();
 		}
 
 		return 0;
 	}
 
 private:
+	// Dispatch each event type in turn until the budget runs out, starting after the type where the last budgeted
+	// dispatch ran out
+	auto dispatch_budgeted(detail::dispatch_budget& budget) -> void {
+		auto frame = detail::frame_scope{frames};
+		auto const count = dispatchers.size();
+
+		for (size_t i = 0; i < count; ++i) {
+			auto const position = (next_dispatcher + i) % count;
+			dispatchers[position].dispatch(budget);
+
+			if (budget.exhausted()) {
+				next_dispatcher = (position + 1) % count;
+				frame.set_incomplete();
+				break;
+			}
+		}
+	}
+
 	template<typename EventT>
 	auto get_or_create_dispatcher() -> detail::discrete_event_dispatcher<EventT, AllocatorT>& {
 		using derived_type = detail::discrete_event_dispatcher<EventT, AllocatorT>;
 
-		auto const [iter, inserted] = dispatchers.try_emplace(std::type_index{typeid(EventT)});
+		auto const id = detail::type_id<EventT>();
 
-		if (inserted) {
-			iter->second = std::allocate_shared<derived_type>(allocator, allocator);
+		if (auto* const dispatcher = dispatchers.find(id)) {
+			return static_cast<derived_type&>(*dispatcher);
 		}
 
-		return static_cast<derived_type&>(*(iter->second));
+		return static_cast<derived_type&>(dispatchers.insert(id, std::allocate_shared<derived_type>(allocator, queue_policy, allocator)));
 	}
 
 	AllocatorT allocator;
-	dispatcher_map_type dispatchers{allocator};
+	shrink_policy queue_policy;
+	frame_arena* frames = nullptr;
+	size_t next_dispatcher = 0;
+	dispatcher_table_type dispatchers{allocator};
 };
 
 
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/dispatcher_table.hpp>
+#include <events/detail/event_arena.hpp>
+#include <events/detail/type_id.hpp>
+#include <events/signal_handler/signal_handler.hpp>
+
+
+namespace events {
+namespace detail {
+
+template<typename EventT = void, typename AllocatorT = std::allocator<void>>
+class ordered_event_handler;
+
+
+template<typename AllocatorT>
+class ordered_event_handler<void, AllocatorT> {
+public:
+	/// The number of events of this type in the queue
+	size_t queued = 0;
+};
+
+
+template<typename EventT, typename AllocatorT>
+class ordered_event_handler final : public ordered_event_handler<void, AllocatorT> {
+public:
+	explicit ordered_event_handler(AllocatorT const& allocator) : handler(allocator) {
+	}
+
+	auto publish(EventT const& event) -> void {
+		handler.publish(event);
+	}
+
+	signal_handler<void(EventT const&), AllocatorT> handler;
+};
+
+}  //namespace detail
+
+
+/**
+ * @brief An @ref event_dispatcher that keeps the events of all types in a single queue, and dispatches them in exact
+ *        enqueue order.
+ *
+ * @details Events are stored back to back in one contiguous arena, each preceded by a small header identifying its
+ *          type, and are dispatched in a single linear pass. This gives a causal ordering across event types, which
+ *          @ref basic_event_dispatcher does not, since it dispatches one event type at a time.
+ *
+ *          Event types must be nothrow move constructible, since events are relocated when the arena grows.
+ */
+template<typename AllocatorT = std::allocator<void>>
+class [[nodiscard]] basic_ordered_event_dispatcher {
+	using alloc_traits = std::allocator_traits<AllocatorT>;
+
+	template<typename EventT>
+	using handler_type = detail::ordered_event_handler<EventT, AllocatorT>;
+
+	using generic_handler = handler_type<void>;
+	using handler_table_type = detail::dispatcher_table<generic_handler, AllocatorT>;
+
+public:
+	using allocator_type = AllocatorT;
+
+	basic_ordered_event_dispatcher() = default;
+
+	explicit basic_ordered_event_dispatcher(AllocatorT const& alloc) : allocator(alloc) {
+	}
+
+	basic_ordered_event_dispatcher(basic_ordered_event_dispatcher const&) = delete;
+
+	/**
+	 * @brief Construct a new basic_ordered_event_dispatcher that will take ownership of another's signal handlers and
+	 *        enqueued events.
+	 *
+	 * @details Existing connection objects from the other event dispatcher are NOT invalidated.
+	 */
+	basic_ordered_event_dispatcher(basic_ordered_event_dispatcher&&) noexcept = default;
+
+	~basic_ordered_event_dispatcher() = default;
+
+	auto operator=(basic_ordered_event_dispatcher const&) -> basic_ordered_event_dispatcher& = delete;
+
+	/**
+	 * @brief Move the signal handlers and enqueued events from a basic_ordered_event_dispatcher into this one
+	 *
+	 * @details Existing connection objects from this event dispatcher are invalidated. Existing connection objects
+	 *          from the other event dispatcher are NOT invalidated, and will now refer to this event dispatcher.
+	 */
+	auto operator=(basic_ordered_event_dispatcher&&) noexcept -> basic_ordered_event_dispatcher& = default;
+
+	[[nodiscard]]
+	constexpr auto get_allocator() const noexcept -> allocator_type {
+		return allocator;
+	}
+
+	/**
+	 * @brief Register a callback function that will be invoked when an event of the specified type is published
+	 *
+	 * @tparam EventT  The type of event this callback handles
+	 * @tparam FunctionT
+	 *
+	 * @param callback  A function which accepts one argument of type EventT
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<typename EventT, std::invocable<EventT const&> FunctionT>
+	auto connect(FunctionT&& callback) -> connection {
+		return get_or_create_handler<EventT>().handler.connect(std::forward<FunctionT>(callback));
+	}
+
+	/**
+	 * @brief Register a member function that will be invoked on an object when an event is published. The event type
+	 *        is deduced from the member function's parameter.
+	 *
+	 * @details Only the object pointer is stored, and the member function is called directly. The object must
+	 *          outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, detail::delegate_event_t<Candidate> const&>
+	auto connect(ObjectT* instance) -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_handler<event_type>().handler.template connect<Candidate>(instance);
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when an event is published. The event type is deduced
+	 *        from the function's parameter.
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), detail::delegate_event_t<Candidate> const&>
+	auto connect() -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_handler<event_type>().handler.template connect<Candidate>();
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 *
+	 * @param event  An instance of the event to enqueue
+	 */
+	template<typename EventT>
+	auto enqueue(EventT&& event) -> void {
+		using event_type = std::remove_cvref_t<EventT>;
+		emplace<event_type>(std::forward<EventT>(event));
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam ArgsT
+	 *
+	 * @param args The arguments requires to construct an instance of this event
+	 */
+	template<typename EventT, typename... ArgsT>
+	requires std::constructible_from<EventT, ArgsT...>
+	auto enqueue(ArgsT&&... args) -> void {
+		emplace<EventT>(std::forward<ArgsT>(args)...);
+	}
+
+	/**
+	 * @brief Enqueue a range of events to be dispatched later
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam RangeT
+	 *
+	 * @param args The range of events to enqueue
+	 */
+	template<typename EventT, std::ranges::range RangeT>
+	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
+	auto enqueue(RangeT&& range) -> void {
+		auto& handler = get_or_create_handler<EventT>();
+
+		for (auto&& event : range) {
+			events.template emplace<EventT>(handler, std::forward<decltype(event)>(event));
+			++handler.queued;
+		}
+	}
+
+	/**
+	 * @brief Send an event immediately
+	 *
+	 * @tparam EventT  The type of event to send
+	 *
+	 * @param args  An instance of the event to send
+	 */
+	template<typename EventT>
+	auto send(EventT&& event) -> void {
+		using event_type = std::remove_cvref_t<EventT>;
+		get_or_create_handler<event_type>().publish(event);
+	}
+
+	/**
+	 * @brief Send an event immediately
+	 *
+	 * @tparam EventT  The type of event to send
+	 * @tparam ArgsT
+	 *
+	 * @param args  The arguments requires to construct an instance of this event
+	 */
+	template<typename EventT, typename... ArgsT>
+	requires std::constructible_from<EventT, ArgsT...>
+	auto send(ArgsT&&... args) -> void {
+		get_or_create_handler<EventT>().publish(EventT{std::forward<ArgsT>(args)...});
+	}
+
+	/**
+	 * @brief Send a range of events immediately
+	 *
+	 * @tparam EventT  The type of event to send
+	 * @tparam RangeT
+	 *
+	 * @param args The range of events to send
+	 */
+	template<typename EventT, std::ranges::range RangeT>
+	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
+	auto send(RangeT&& range) -> void {
+		auto& handler = get_or_create_handler<EventT>();
+
+		for (auto&& event : range) {
+			handler.publish(event);
+		}
+	}
+
+	/// Dispatch all events in the queue, in the order they were enqueued
+	auto dispatch() -> void {
+		for (auto const& handler : handlers) {
+			handler->queued = 0;
+		}
+
+		// Dispatching from a separate arena allows events to be enqueued during dispatch
+		auto to_publish = std::exchange(events, arena_type{allocator});
+		to_publish.publish_all();
+		to_publish.clear();
+
+		// Keep the larger buffer for reuse if nothing was enqueued during dispatch
+		if (events.empty() && to_publish.capacity_bytes() > events.capacity_bytes()) {
+			events = std::move(to_publish);
+		}
+	}
+
+	/// Discard all enqueued events
+	auto clear() -> void {
+		for (auto const& handler : handlers) {
+			handler->queued = 0;
+		}
+
+		events.clear();
+	}
+
+	/**
+	 * @brief Get the number of enqueued events for a specific event type or for all events
+	 *
+	 * @tparam EventT  The type of event to get the count of. Leave default (void) to obtain the total number of
+	 *                 enqueued events.
+	 *
+	 * @return The number of enqueued events
+	 */
+	template<typename EventT = void>
+	[[nodiscard]]
+	auto queue_size() const -> size_t {
+		if constexpr (std::same_as<void, EventT>) {
+			return events.size();
+		}
+		else {
+			if (auto* const handler = handlers.find(detail::type_id<EventT>())) {
+				return handler->queued;
+			}
+
+			return 0;
+		}
+	}
+
+private:
+	using arena_type = detail::event_arena<AllocatorT>;
+
+	template<typename EventT, typename... ArgsT>
+	auto emplace(ArgsT&&... args) -> void {
+		auto& handler = get_or_create_handler<EventT>();
+
+		events.template emplace<EventT>(handler, std::forward<ArgsT>(args)...);
+		++handler.queued;
+	}
+
+	template<typename EventT>
+	auto get_or_create_handler() -> handler_type<EventT>& {
+		auto const id = detail::type_id<EventT>();
+
+		if (auto* const handler = handlers.find(id)) {
+			return static_cast<handler_type<EventT>&>(*handler);
+		}
+
+		return static_cast<handler_type<EventT>&>(handlers.insert(id, std::allocate_shared<handler_type<EventT>>(allocator, allocator)));
+	}
+
+	AllocatorT allocator;
+	handler_table_type handlers{allocator};
+	arena_type events{allocator};
+};
+
+
+/// Type alias for a basic_ordered_event_dispatcher with the default template arguments
+using ordered_event_dispatcher = basic_ordered_event_dispatcher<>;
+
+}  //namespace events
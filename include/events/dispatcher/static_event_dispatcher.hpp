@@ -0,0 +1,465 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/dispatch_budget.hpp>
+#include <events/dispatcher/event_channel.hpp>
+#include <events/dispatcher/event_dispatcher.hpp>
+#include <events/frame_arena.hpp>
+
+
+namespace events {
+namespace detail {
+
+template<typename T, typename... Ts>
+concept one_of = (std::same_as<T, Ts> || ...);
+
+template<typename... Ts>
+inline constexpr bool unique_types = true;
+
+template<typename T, typename... Ts>
+inline constexpr bool unique_types<T, Ts...> = !one_of<T, Ts...> && unique_types<Ts...>;
+
+}  //namespace detail
+
+
+/**
+ * @brief An @ref event_dispatcher over a fixed set of event types. The discrete dispatcher for each event type is
+ *        stored directly, so looking one up is resolved at compile time, and dispatching all events is an unrolled
+ *        sequence of direct calls in the order the event types are listed.
+ *
+ * @details Using an event type that isn't in the list is a compile error. Unlike @ref basic_event_dispatcher, moving a
+ *          static event dispatcher moves its signal handlers, so existing connection objects are invalidated.
+ *
+ * @tparam EventsT  The event types this dispatcher handles. Each type may only appear once.
+ */
+template<typename AllocatorT, typename... EventsT>
+class [[nodiscard]] basic_static_event_dispatcher {
+	static_assert(detail::unique_types<EventsT...>, "Each event type may only be listed once");
+
+	template<typename EventT>
+	using dispatcher_type = detail::discrete_event_dispatcher<EventT, AllocatorT>;
+
+public:
+	using allocator_type = AllocatorT;
+
+	basic_static_event_dispatcher() : basic_static_event_dispatcher(AllocatorT{}) {
+	}
+
+	explicit basic_static_event_dispatcher(AllocatorT const& alloc) :
+		allocator(alloc),
+		dispatchers(dispatcher_type<EventsT>{allocator}...) {
+	}
+
+	/**
+	 * @brief Construct a new basic_static_event_dispatcher whose event queues release unused memory according to a
+	 *        shrink policy. By default, event queues keep their largest capacity.
+	 */
+	explicit basic_static_event_dispatcher(shrink_policy policy, AllocatorT const& alloc = AllocatorT{}) :
+		allocator(alloc),
+		dispatchers(dispatcher_type<EventsT>{policy, allocator}...) {
+	}
+
+	/**
+	 * @brief Construct a new basic_static_event_dispatcher that starts a new frame of a @ref frame_arena on every
+	 *        dispatch. Events whose members were allocated from the arena are released wholesale once they are
+	 *        dispatched.
+	 *
+	 * @details The arena must outlive this event dispatcher, and must not be attached to any other event dispatcher.
+	 */
+	explicit basic_static_event_dispatcher(frame_arena& arena, shrink_policy policy = {}, AllocatorT const& alloc = AllocatorT{}) :
+		allocator(alloc),
+		frames(&arena),
+		dispatchers(dispatcher_type<EventsT>{policy, allocator}...) {
+	}
+
+	basic_static_event_dispatcher(basic_static_event_dispatcher const&) = delete;
+
+	/**
+	 * @brief Construct a new basic_static_event_dispatcher that will take ownership of another's signal handlers and
+	 *        enqueued events.
+	 *
+	 * @details Existing connection objects from the other event dispatcher are invalidated.
+	 */
+	basic_static_event_dispatcher(basic_static_event_dispatcher&& other) noexcept :
+		allocator(std::move(other.allocator)),
+		frames(std::exchange(other.frames, nullptr)),
+		dispatchers(std::move(other.dispatchers)),
+		next_dispatcher(std::exchange(other.next_dispatcher, 0)) {
+	}
+
+	~basic_static_event_dispatcher() = default;
+
+	auto operator=(basic_static_event_dispatcher const&) -> basic_static_event_dispatcher& = delete;
+
+	/**
+	 * @brief Move the signal handlers and enqueued events from a basic_static_event_dispatcher into this one
+	 * @details Existing connection objects from both event dispatchers are invalidated.
+	 */
+	auto operator=(basic_static_event_dispatcher&& other) noexcept -> basic_static_event_dispatcher& {
+		if (&other != this) {
+			allocator = std::move(other.allocator);
+			frames = std::exchange(other.frames, nullptr);
+			dispatchers = std::move(other.dispatchers);
+			next_dispatcher = std::exchange(other.next_dispatcher, 0);
+		}
+		return *this;
+	}
+
+	[[nodiscard]]
+	constexpr auto get_allocator() const noexcept -> allocator_type {
+		return allocator;
+	}
+
+	/**
+	 * @brief Register a callback function that will be invoked when an event of the specified type is published
+	 *
+	 * @tparam EventT  The type of event this callback handles
+	 * @tparam FunctionT
+	 *
+	 * @param callback  A function which accepts one argument of type EventT
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<detail::one_of<EventsT...> EventT, std::invocable<EventT const&> FunctionT>
+	auto connect(FunctionT&& callback) -> connection {
+		return get<EventT>().connect(std::forward<FunctionT>(callback));
+	}
+
+	/**
+	 * @brief Register a member function that will be invoked on an object when an event is published. The event type
+	 *        is deduced from the member function's parameter.
+	 *
+	 * @details The callback holds nothing but the object pointer, so it fits in the inline buffer of std::function
+	 *          or @ref small_function and connecting doesn't allocate. It is still invoked through the callback
+	 *          wrapper, like any other callback. The object must outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires detail::one_of<detail::delegate_event_t<Candidate>, EventsT...>
+	      && std::invocable<decltype(Candidate), ObjectT*, detail::delegate_event_t<Candidate> const&>
+	auto connect(ObjectT* instance) -> connection {
+		return get<detail::delegate_event_t<Candidate>>().template connect<Candidate>(instance);
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when an event is published. The event type is deduced
+	 *        from the function's parameter.
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate>
+	requires detail::one_of<detail::delegate_event_t<Candidate>, EventsT...>
+	      && std::invocable<decltype(Candidate), detail::delegate_event_t<Candidate> const&>
+	auto connect() -> connection {
+		return get<detail::delegate_event_t<Candidate>>().template connect<Candidate>();
+	}
+
+	/**
+	 * @brief Register a callback function that will be invoked once per dispatch with all of the dispatched events of
+	 *        the specified type, as a contiguous span, instead of once per event
+	 *
+	 * @details Batch listeners are invoked before the per-event listeners of the same events. Events which are
+	 *          sent immediately are passed to batch listeners as a span of one event.
+	 *
+	 * @tparam EventT  The type of event this callback handles
+	 * @tparam FunctionT
+	 *
+	 * @param callback  A function which accepts one argument of type std::span<EventT const>
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<detail::one_of<EventsT...> EventT, std::invocable<std::span<EventT const>> FunctionT>
+	auto connect_batch(FunctionT&& callback) -> connection {
+		return get<EventT>().connect_batch(std::forward<FunctionT>(callback));
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 *
+	 * @param event  An instance of the event to enqueue
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
+	 */
+	template<typename EventT>
+	requires detail::one_of<std::remove_cvref_t<EventT>, EventsT...>
+	auto enqueue(EventT&& event) -> bool {
+		return get<std::remove_cvref_t<EventT>>().enqueue(std::forward<EventT>(event));
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam ArgsT
+	 *
+	 * @param args The arguments requires to construct an instance of this event
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
+	 */
+	template<detail::one_of<EventsT...> EventT, typename... ArgsT>
+	requires std::constructible_from<EventT, ArgsT...>
+	auto enqueue(ArgsT&&... args) -> bool {
+		return get<EventT>().enqueue(std::forward<ArgsT>(args)...);
+	}
+
+	/**
+	 * @brief Enqueue a range of events to be dispatched later
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam RangeT
+	 *
+	 * @param args The range of events to enqueue
+	 *
+	 * @return The number of events that were enqueued
+	 */
+	template<detail::one_of<EventsT...> EventT, std::ranges::range RangeT>
+	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
+	auto enqueue(RangeT&& range) -> size_t {
+		return get<EventT>().enqueue(std::forward<RangeT>(range));
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later, or merge it into a pending event with the same key. A merged
+	 *        event keeps the position of the pending event, so only the latest state per key is dispatched.
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam KeyT
+	 * @tparam MergeT
+	 *
+	 * @param key    The key that identifies which events are coalesced. Must be hashable with std::hash.
+	 * @param event  An instance of the event to enqueue
+	 * @param merge  A function which accepts the pending event by reference and the new event by rvalue reference,
+	 *               and updates the pending event. By default, the pending event is replaced.
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
+	 */
+	template<detail::one_of<EventsT...> EventT, typename KeyT, typename MergeT = detail::replace_event>
+	requires std::invocable<MergeT&, EventT&, EventT&&>
+	auto enqueue_coalesced(KeyT const& key, EventT event, MergeT merge = {}) -> bool {
+		return get<EventT>().enqueue_coalesced(key, std::move(event), merge);
+	}
+
+	/**
+	 * @brief Send an event immediately
+	 *
+	 * @tparam EventT  The type of event to send
+	 *
+	 * @param args  An instance of the event to send
+	 */
+	template<typename EventT>
+	requires detail::one_of<std::remove_cvref_t<EventT>, EventsT...>
+	auto send(EventT&& event) -> void {
+		get<std::remove_cvref_t<EventT>>().send(std::forward<EventT>(event));
+	}
+
+	/**
+	 * @brief Send an event immediately
+	 *
+	 * @tparam EventT  The type of event to send
+	 * @tparam ArgsT
+	 *
+	 * @param args  The arguments requires to construct an instance of this event
+	 */
+	template<detail::one_of<EventsT...> EventT, typename... ArgsT>
+	requires std::constructible_from<EventT, ArgsT...>
+	auto send(ArgsT&&... args) -> void {
+		get<EventT>().send(EventT{std::forward<ArgsT>(args)...});
+	}
+
+	/**
+	 * @brief Send a range of events immediately
+	 *
+	 * @tparam EventT  The type of event to send
+	 * @tparam RangeT
+	 *
+	 * @param args The range of events to send
+	 */
+	template<detail::one_of<EventsT...> EventT, std::ranges::range RangeT>
+	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
+	auto send(RangeT&& range) -> void {
+		get<EventT>().send(std::forward<RangeT>(range));
+	}
+
+	/**
+	 * @brief Get a channel for an event type. A channel can enqueue and send events of that type without looking up
+	 *        the event type on every call.
+	 *
+	 * @tparam EventT  The type of event the channel handles
+	 *
+	 * @return A channel that is valid for the lifetime of this event dispatcher, until it is moved
+	 */
+	template<detail::one_of<EventsT...> EventT>
+	[[nodiscard]]
+	auto channel() -> event_channel<dispatcher_type<EventT>> {
+		return event_channel{get<EventT>()};
+	}
+
+	/// Dispatch all events in the queue, one event type at a time in the order the types are listed
+	auto dispatch() -> void {
+		auto const frame = detail::frame_scope{frames};
+		(get<EventsT>().dispatch(), ...);
+	}
+
+	/**
+	 * @brief Dispatch at most a number of enqueued events. Events that don't fit in the budget stay in the queue, in
+	 *        order, and are dispatched first by the next call. Each call starts with the event type after the one
+	 *        where the previous call ran out, so that a busy event type can't starve the others.
+	 *
+	 * @param max_events  The maximum number of events to dispatch
+	 *
+	 * @return The number of events dispatched
+	 */
+	auto dispatch_n(size_t max_events) -> size_t {
+		auto budget = detail::dispatch_budget{max_events};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
+	/**
+	 * @brief Dispatch enqueued events until a time budget runs out. The budget is checked before each event, so a slow
+	 *        callback can overrun it. Events that weren't dispatched are resumed by the next call, like
+	 *        @ref dispatch_n.
+	 *
+	 * @param duration  The time budget
+	 *
+	 * @return The number of events dispatched
+	 */
+	template<typename RepT, typename PeriodT>
+	auto dispatch_for(std::chrono::duration<RepT, PeriodT> duration) -> size_t {
+		using clock_type = detail::dispatch_budget::clock_type;
+
+		auto budget = detail::dispatch_budget{clock_type::now() + std::chrono::ceil<clock_type::duration>(duration)};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
+	/// Discard all enqueued events
+	auto clear() -> void {
+		(get<EventsT>().clear(), ...);
+	}
+
+	/**
+	 * @brief Limit the number of pending events of a specific type. Events which are already pending are kept, even
+	 *        if there are more than the new capacity.
+	 *
+	 * @tparam EventT  The type of event to limit
+	 *
+	 * @param capacity  The maximum number of pending events, or 0 for no limit
+	 * @param policy    What to do with an event that is enqueued while the queue is full
+	 */
+	template<typename EventT>
+	requires detail::one_of<EventT, EventsT...>
+	auto set_queue_capacity(size_t capacity, overflow_policy policy = overflow_policy::drop_newest) -> void {
+		get<EventT>().set_capacity(capacity, policy);
+	}
+
+	/**
+	 * @brief Get the number of enqueued events for a specific event type or for all events
+	 *
+	 * @tparam EventT  The type of event to get the count of. Leave default (void) to obtain the total number of
+	 *                 enqueued events.
+	 *
+	 * @return The number of enqueued events
+	 */
+	template<typename EventT = void>
+	requires std::same_as<void, EventT> || detail::one_of<EventT, EventsT...>
+	[[nodiscard]]
+	auto queue_size() const -> size_t {
+		if constexpr (std::same_as<void, EventT>) {
+			return (size_t{0} + ... + get<EventsT>().size());
+		}
+		else {
+			return get<EventT>().size();
+		}
+	}
+
+	/**
+	 * @brief Get the number of events that were discarded because their queue was full, for a specific event type or
+	 *        for all events
+	 *
+	 * @tparam EventT  The type of event to get the count of. Leave default (void) to obtain the total number of
+	 *                 dropped events.
+	 *
+	 * @return The number of dropped events
+	 */
+	template<typename EventT = void>
+	requires std::same_as<void, EventT> || detail::one_of<EventT, EventsT...>
+	[[nodiscard]]
+	auto dropped_count() const -> size_t {
+		if constexpr (std::same_as<void, EventT>) {
+			return (size_t{0} + ... + get<EventsT>().dropped());
+		}
+		else {
+			return get<EventT>().dropped();
+		}
+	}
+
+private:
+	// Dispatch each event type in turn until the budget runs out, starting after the type where the last budgeted
+	// dispatch ran out
+	auto dispatch_budgeted(detail::dispatch_budget& budget) -> void {
+		auto frame = detail::frame_scope{frames};
+
+		for (size_t i = 0; i < sizeof...(EventsT); ++i) {
+			auto const position = (next_dispatcher + i) % sizeof...(EventsT);
+			dispatch_at(position, budget);
+
+			if (budget.exhausted()) {
+				next_dispatcher = (position + 1) % sizeof...(EventsT);
+				frame.set_incomplete();
+				break;
+			}
+		}
+	}
+
+	auto dispatch_at(size_t position, detail::dispatch_budget& budget) -> void {
+		std::apply([&](auto&... dispatcher) {
+			auto current = size_t{0};
+			((current++ == position ? dispatcher.dispatch(budget) : void()), ...);
+		}, dispatchers);
+	}
+
+	template<typename EventT>
+	[[nodiscard]]
+	auto get() noexcept -> dispatcher_type<EventT>& {
+		return std::get<dispatcher_type<EventT>>(dispatchers);
+	}
+
+	template<typename EventT>
+	[[nodiscard]]
+	auto get() const noexcept -> dispatcher_type<EventT> const& {
+		return std::get<dispatcher_type<EventT>>(dispatchers);
+	}
+
+	AllocatorT allocator;
+	frame_arena* frames = nullptr;
+	std::tuple<dispatcher_type<EventsT>...> dispatchers;
+	size_t next_dispatcher = 0;
+};
+
+
+/// Type alias for a basic_static_event_dispatcher with the default allocator
+template<typename... EventsT>
+using static_event_dispatcher = basic_static_event_dispatcher<std::allocator<void>, EventsT...>;
+
+}  //namespace events
@@ -1,18 +1,26 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <concepts>
-#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <ranges>
 #include <shared_mutex>
-#include <typeinfo>
-#include <typeindex>
-#include <vector>
+#include <span>
 
 #include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/dispatch_budget.hpp>
+#include <events/detail/concurrent_dispatcher_table.hpp>
+#include <events/detail/dispatch_graph.hpp>
+#include <events/detail/double_buffered_queue.hpp>
+#include <events/detail/mpsc_queue.hpp>
+#include <events/detail/thread_local_buffers.hpp>
+#include <events/detail/type_id.hpp>
+#include <events/dispatcher/event_channel.hpp>
 #include <events/signal_handler/synchronized_signal_handler.hpp>
 
 
@@ -39,34 +47,58 @@ public:
 	    -> synchronized_discrete_event_dispatcher& = default;
 
 	virtual auto dispatch() -> void = 0;
+	virtual auto dispatch(dispatch_budget& budget) -> void = 0;
 	virtual auto clear() -> void = 0;
 	virtual auto size() -> size_t = 0;
+	virtual auto dropped() -> size_t = 0;
 };
 
 
 template<typename EventT, typename AllocatorT>
 class [[nodiscard]] synchronized_discrete_event_dispatcher final : public synchronized_discrete_event_dispatcher<void, AllocatorT> {
-	using event_allocator_type = typename std::allocator_traits<AllocatorT>::template rebind_alloc<EventT>;
-	using event_container_type = std::vector<EventT, event_allocator_type>;
+	using event_queue_type = double_buffered_queue<EventT, AllocatorT>;
 
 public:
+	using event_type = EventT;
+
 	synchronized_discrete_event_dispatcher() = default;
 
-	explicit synchronized_discrete_event_dispatcher(AllocatorT const& alloc) : handler(alloc), events(alloc) {
+	explicit synchronized_discrete_event_dispatcher(AllocatorT const& alloc) :
+		handler(alloc),
+		batch_handler(alloc),
+		events(alloc),
+		pending(alloc),
+		staged(alloc) {
+	}
+
+	synchronized_discrete_event_dispatcher(shrink_policy policy, AllocatorT const& alloc) :
+		handler(alloc),
+		batch_handler(alloc),
+		events(policy, alloc),
+		pending(alloc),
+		staged(alloc) {
 	}
 
 	synchronized_discrete_event_dispatcher(synchronized_discrete_event_dispatcher const&) = delete;
 
 	synchronized_discrete_event_dispatcher(synchronized_discrete_event_dispatcher&& other) {
 		auto lock = std::scoped_lock{other.events_mut};
+		other.collect_pending();
 		handler = std::move(other.handler);
+		batch_handler = std::move(other.batch_handler);
 		events = std::move(other.events);
+		bounded.store(other.bounded.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	}
 
-	synchronized_discrete_event_dispatcher(synchronized_discrete_event_dispatcher&& other, AllocatorT const& alloc) {
+	synchronized_discrete_event_dispatcher(synchronized_discrete_event_dispatcher&& other, AllocatorT const& alloc) :
+		pending(alloc),
+		staged(alloc) {
 		auto lock = std::scoped_lock{other.events_mut};
+		other.collect_pending();
 		handler = decltype(handler){std::move(other.handler), alloc};
-		events = event_container_type{std::move(other.events), alloc};
+		batch_handler = decltype(batch_handler){std::move(other.batch_handler), alloc};
+		events = event_queue_type{std::move(other.events), alloc};
+		bounded.store(other.bounded.load(std::memory_order_relaxed), std::memory_order_relaxed);
 	}
 
 	~synchronized_discrete_event_dispatcher() override = default;
@@ -75,8 +107,12 @@ public:
 
 	auto operator=(synchronized_discrete_event_dispatcher&& other) -> synchronized_discrete_event_dispatcher& {
 		auto lock = std::scoped_lock{events_mut, other.events_mut};
+		collect_pending();
+		other.collect_pending();
 		handler = std::move(other.handler);
+		batch_handler = std::move(other.batch_handler);
 		events = std::move(other.events);
+		bounded.store(other.bounded.load(std::memory_order_relaxed), std::memory_order_relaxed);
 		return *this;
 	}
 
@@ -85,19 +121,60 @@ public:
 		return handler.connect(std::forward<FunctionT>(callback));
 	}
 
+	template<auto Candidate, typename ObjectT>
+	auto connect(ObjectT* instance) -> connection {
+		return handler.template connect<Candidate>(instance);
+	}
+
+	template<auto Candidate>
+	auto connect() -> connection {
+		return handler.template connect<Candidate>();
+	}
+
+	template<std::invocable<std::span<EventT const>> FunctionT>
+	auto connect_batch(FunctionT&& callback) -> connection {
+		return batch_handler.connect(std::forward<FunctionT>(callback));
+	}
+
 	auto dispatch() -> void override {
-		// Moving the vector and iterating over a local one allows events to be enqueued during iteration
+		// Publishing from the front buffer allows events to be enqueued during iteration. The batch is released
+		// without the lock, which the queue allows.
 		auto lock = std::unique_lock{events_mut};
-		auto to_publish = std::move(events);
-		events.clear();
+		collect_pending();
+		auto to_publish = events.acquire();
 		lock.unlock();
 
-		for (auto const& event : to_publish) {
-			handler.publish(event);
+		publish_all(to_publish.events());
+	}
+
+	auto dispatch(dispatch_budget& budget) -> void override {
+		auto lock = std::unique_lock{events_mut};
+		collect_pending();
+		auto to_publish = events.resume();
+		lock.unlock();
+
+		auto count = size_t{0};
+
+		if (batch_handler.size() == 0) {
+			for (auto const& event : to_publish) {
+				if (!budget.take()) {
+					break;
+				}
+				handler.publish(event);
+				++count;
+			}
+		}
+		else {
+			// Batch listeners receive all of the events at once, so the budget is claimed before publishing
+			count = budget.take(to_publish.events().size());
+			publish_all(to_publish.events().first(count));
 		}
+
+		to_publish.keep_after(count);
 	}
 
 	auto send(EventT const& event) -> void {
+		batch_handler.publish(std::span{&event, 1});
 		handler.publish(event);
 	}
 
@@ -105,38 +182,108 @@ public:
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
 	auto send(RangeT&& range) -> void {
 		for (auto&& event : range) {
-			handler.publish(event);
+			send(event);
 		}
 	}
 
+	// Unbounded queues are enqueued to without locking. Bounded queues need the lock to apply their overflow policy.
+	// An enqueue that races with set_capacity() may see the queue as unbounded, in which case the capacity is applied
+	// when the event is collected.
 	template<typename... ArgsT>
 	requires std::constructible_from<EventT, ArgsT...>
-	auto enqueue(ArgsT&&... args) -> void {
+	auto enqueue(ArgsT&&... args) -> bool {
+		if (!bounded.load(std::memory_order_relaxed)) {
+			pending.emplace(std::forward<ArgsT>(args)...);
+			return true;
+		}
+
 		auto lock = std::scoped_lock{events_mut};
-		events.emplace_back(std::forward<ArgsT>(args)...);
+		collect_pending();
+		return events.emplace(std::forward<ArgsT>(args)...);
 	}
 
 	template<std::ranges::range RangeT>
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
-	auto enqueue(RangeT&& range) -> void {
+	auto enqueue(RangeT&& range) -> size_t {
+		if (!bounded.load(std::memory_order_relaxed)) {
+			auto count = size_t{0};
+			for (auto&& event : range) {
+				pending.emplace(std::forward<decltype(event)>(event));
+				++count;
+			}
+			return count;
+		}
+
+		auto lock = std::scoped_lock{events_mut};
+		collect_pending();
+		return events.insert(std::forward<RangeT>(range));
+	}
+
+	// The capacity and overflow policy are applied when the events are collected
+	template<typename... ArgsT>
+	requires std::constructible_from<EventT, ArgsT...>
+	auto enqueue_local(ArgsT&&... args) -> void {
+		staged.emplace(std::forward<ArgsT>(args)...);
+	}
+
+	template<typename KeyT, typename MergeT>
+	auto enqueue_coalesced(KeyT const& key, EventT&& event, MergeT& merge) -> bool {
+		auto lock = std::scoped_lock{events_mut};
+		collect_pending();
+		return events.emplace_coalesced(key, std::move(event), merge);
+	}
+
+	auto set_capacity(size_t capacity, overflow_policy policy) -> void {
 		auto lock = std::scoped_lock{events_mut};
-		events.insert(events.end(), std::ranges::begin(range), std::ranges::end(range));
+		collect_pending();
+		events.set_capacity(capacity, policy);
+		bounded.store(capacity != 0, std::memory_order_relaxed);
 	}
 
 	auto clear() -> void override {
 		auto lock = std::scoped_lock{events_mut};
+		collect_pending();
 		events.clear();
 	}
 
 	auto size() -> size_t override {
-		return events.size();
+		auto lock = std::scoped_lock{events_mut};
+		return events.size() + pending.size() + staged.size();
+	}
+
+	auto dropped() -> size_t override {
+		return events.dropped();
 	}
 
 private:
+	// Move the events enqueued without locking into the queue, after any events already in it. Requires events_mut.
+	auto collect_pending() -> void {
+		auto const collect = [this](EventT&& event) { events.emplace(std::move(event)); };
+		pending.consume(collect);
+		staged.consume(collect);
+	}
+
+	// Batch listeners are invoked before the per-event listeners
+	auto publish_all(std::span<EventT const> to_publish) -> void {
+		batch_handler.publish(to_publish);
+
+		for (auto const& event : to_publish) {
+			handler.publish(event);
+		}
+	}
+
 	synchronized_signal_handler<void(EventT const&), AllocatorT> handler;
+	synchronized_signal_handler<void(std::span<EventT const>), AllocatorT> batch_handler;
 
-	event_container_type events;
+	event_queue_type events;
 	std::mutex events_mut;
+
+	// Events enqueued without taking events_mut, which are collected into the queue before each dispatch
+	mpsc_queue<EventT, AllocatorT> pending;
+	std::atomic<bool> bounded = false;
+
+	// Events enqueued to the enqueuing thread's own buffer
+	thread_local_buffers<EventT, AllocatorT> staged;
 };
 
 }  //namespace detail
@@ -144,6 +291,12 @@ private:
 
 /**
  * @brief A thread-safe @ref event_dispatcher
+ *
+ * @details Events of types without a queue capacity are enqueued to a lock-free queue, so producers don't contend with
+ *          each other or with dispatch. They're moved into the dispatch queue at the start of the next dispatch.
+ *          Coalesced events, and events of types with a capacity, take a per-type lock instead. Events enqueued with
+ *          enqueue_local() are buffered per thread, and collected at the start of the next dispatch.
+ *          parallel_dispatch() dispatches independent event types concurrently on an executor.
  */
 template<typename AllocatorT = std::allocator<void>>
 class [[nodiscard]] basic_synchronized_event_dispatcher {
@@ -152,9 +305,8 @@ class [[nodiscard]] basic_synchronized_event_dispatcher {
 	using generic_dispatcher = detail::synchronized_discrete_event_dispatcher<void, AllocatorT>;
 	using generic_dispatcher_pointer = std::shared_ptr<generic_dispatcher>;
 
-	using dispatcher_map_element_type = std::pair<const std::type_index, generic_dispatcher_pointer>;
-	using dispatcher_allocator_type = typename alloc_traits::template rebind_alloc<dispatcher_map_element_type>;
-	using dispatcher_map_type = std::map<std::type_index, generic_dispatcher_pointer, std::less<>, dispatcher_allocator_type>;
+	using dispatcher_table_type = detail::concurrent_dispatcher_table<generic_dispatcher, AllocatorT>;
+	using dispatch_graph_type = detail::dispatch_graph<AllocatorT>;
 
 public:
 	using allocator_type = AllocatorT;
@@ -164,13 +316,24 @@ public:
 	explicit basic_synchronized_event_dispatcher(AllocatorT const& alloc) : allocator(alloc) {
 	}
 
+	/**
+	 * @brief Construct a new basic_synchronized_event_dispatcher whose event queues release unused memory according
+	 *        to a shrink policy. By default, event queues keep their largest capacity.
+	 */
+	explicit basic_synchronized_event_dispatcher(shrink_policy policy, AllocatorT const& alloc = AllocatorT{}) :
+		allocator(alloc),
+		queue_policy(policy) {
+	}
+
 	basic_synchronized_event_dispatcher(basic_synchronized_event_dispatcher const&) = delete;
 
 	/**
 	 * @brief Construct a new synchronized_event_dispatcher that will take ownership of another's signal handlers and
 	 *        enqueued events.
 	 *
-	 * @details Existing connection objects from the other event dispatcher are NOT invalidated.
+	 * @details Existing connection objects from the other event dispatcher are NOT invalidated. Other threads may keep
+	 *          enqueuing events to the other event dispatcher while it is moved from, and each event ends up in one of
+	 *          the two event dispatchers.
 	 */
 	basic_synchronized_event_dispatcher(basic_synchronized_event_dispatcher&& other) {
 		auto lock = std::scoped_lock{other.dispatcher_mut};
@@ -179,14 +342,18 @@ public:
 			allocator = std::move(other.allocator);
 		}
 
+		queue_policy = other.queue_policy;
 		dispatchers = std::move(other.dispatchers);
+		dispatch_order = std::move(other.dispatch_order);
 	}
 
 	/**
 	 * @brief Construct a new basic_synchronized_event_dispatcher that will take ownership of another's signal handlers and
 	 *        enqueued events.
 	 *
-	 * @details Existing connection objects from the other event dispatcher are NOT invalidated.
+	 * @details Existing connection objects from the other event dispatcher are NOT invalidated. Other threads may keep
+	 *          enqueuing events to the other event dispatcher while it is moved from, and each event ends up in one of
+	 *          the two event dispatchers.
 	 */
 	basic_synchronized_event_dispatcher(basic_synchronized_event_dispatcher&& other, AllocatorT const& alloc) : allocator(alloc) {
 		auto lock = std::scoped_lock{other.dispatcher_mut};
@@ -195,7 +362,9 @@ public:
 			allocator = std::move(other.allocator);
 		}
 
-		dispatchers = dispatcher_map_type{std::move(other.dispatchers), allocator};
+		queue_policy = other.queue_policy;
+		dispatchers = dispatcher_table_type{std::move(other.dispatchers), allocator};
+		dispatch_order = dispatch_graph_type{std::move(other.dispatch_order), allocator};
 	}
 
 	~basic_synchronized_event_dispatcher() = default;
@@ -207,6 +376,9 @@ public:
 	 *
 	 * @details Existing connection objects from this event dispatcher are invalidated. Existing connection objects
 	 *          from the other event dispatcher are NOT invalidated, and will now refer to this event dispatcher.
+	 *
+	 *          Event types are looked up without locking, and this event dispatcher's per-type dispatchers are
+	 *          destroyed by the move, so other threads must not use this event dispatcher during the move.
 	 */
 	auto operator=(basic_synchronized_event_dispatcher&& other) -> basic_synchronized_event_dispatcher& {
 		if (&other == this) {
@@ -219,7 +391,9 @@ public:
 			allocator = std::move(other.allocator);
 		}
 
+		queue_policy = other.queue_policy;
 		dispatchers = std::move(other.dispatchers);
+		dispatch_order = std::move(other.dispatch_order);
 
 		return *this;
 	}
@@ -244,6 +418,61 @@ public:
 		return get_or_create_dispatcher<EventT>().connect(std::forward<FunctionT>(callback));
 	}
 
+	/**
+	 * @brief Register a member function that will be invoked on an object when an event is published. The event type
+	 *        is deduced from the member function's parameter.
+	 *
+	 * @details The callback holds nothing but the object pointer, so it fits in the inline buffer of std::function
+	 *          or @ref small_function and connecting doesn't allocate. It is still invoked through the callback
+	 *          wrapper, like any other callback. The object must outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, detail::delegate_event_t<Candidate> const&>
+	auto connect(ObjectT* instance) -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_dispatcher<event_type>().template connect<Candidate>(instance);
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when an event is published. The event type is deduced
+	 *        from the function's parameter.
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), detail::delegate_event_t<Candidate> const&>
+	auto connect() -> connection {
+		using event_type = detail::delegate_event_t<Candidate>;
+		return get_or_create_dispatcher<event_type>().template connect<Candidate>();
+	}
+
+	/**
+	 * @brief Register a callback function that will be invoked once per dispatch with all of the dispatched events of
+	 *        the specified type, as a contiguous span, instead of once per event
+	 *
+	 * @details Batch listeners are invoked before the per-event listeners of the same events. Events which are
+	 *          sent immediately are passed to batch listeners as a span of one event.
+	 *
+	 * @tparam EventT  The type of event this callback handles
+	 * @tparam FunctionT
+	 *
+	 * @param callback  A function which accepts one argument of type std::span<EventT const>
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this event dispatcher
+	 */
+	template<typename EventT, std::invocable<std::span<EventT const>> FunctionT>
+	auto connect_batch(FunctionT&& callback) -> connection {
+		return get_or_create_dispatcher<EventT>().connect_batch(std::forward<FunctionT>(callback));
+	}
+
 
 	/**
 	 * @brief Enqueue an event to be dispatched later
@@ -251,11 +480,13 @@ public:
 	 * @tparam EventT  The type of event to enqueue
 	 *
 	 * @param event  An instance of the event to enqueue
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
 	 */
 	template<typename EventT>
-	auto enqueue(EventT&& event) -> void {
+	auto enqueue(EventT&& event) -> bool {
 		using event_type = std::remove_cvref_t<EventT>;
-		get_or_create_dispatcher<event_type>().enqueue(std::forward<EventT>(event));
+		return get_or_create_dispatcher<event_type>().enqueue(std::forward<EventT>(event));
 	}
 
 	/**
@@ -265,11 +496,13 @@ public:
 	 * @tparam ArgsT
 	 *
 	 * @param args The arguments requires to construct an instance of this event
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
 	 */
 	template<typename EventT, typename... ArgsT>
 	requires std::constructible_from<EventT, ArgsT...>
-	auto enqueue(ArgsT&&... args) -> void {
-		get_or_create_dispatcher<EventT>().enqueue(std::forward<ArgsT>(args)...);
+	auto enqueue(ArgsT&&... args) -> bool {
+		return get_or_create_dispatcher<EventT>().enqueue(std::forward<ArgsT>(args)...);
 	}
 
 	/**
@@ -279,11 +512,68 @@ public:
 	 * @tparam RangeT
 	 *
 	 * @param args The range of events to enqueue
+	 *
+	 * @return The number of events that were enqueued
 	 */
 	template<typename EventT, std::ranges::range RangeT>
 	requires std::convertible_to<std::ranges::range_value_t<RangeT>, EventT>
-	auto enqueue(RangeT&& range) -> void {
-		get_or_create_dispatcher<EventT>().enqueue(std::forward<RangeT>(range));
+	auto enqueue(RangeT&& range) -> size_t {
+		return get_or_create_dispatcher<EventT>().enqueue(std::forward<RangeT>(range));
+	}
+
+	/**
+	 * @brief Enqueue an event to the calling thread's own buffer, to be dispatched later
+	 *
+	 * @details Each thread appends to a separate buffer for each event type, so threads that enqueue many events
+	 *          don't share any cache lines until the buffers are collected at the start of the next dispatch. Events
+	 *          keep their order per thread, but are dispatched after events enqueued with enqueue() before the same
+	 *          dispatch. The queue capacity of the event type is applied when the events are collected.
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 *
+	 * @param event  An instance of the event to enqueue
+	 */
+	template<typename EventT>
+	auto enqueue_local(EventT&& event) -> void {
+		using event_type = std::remove_cvref_t<EventT>;
+		get_or_create_dispatcher<event_type>().enqueue_local(std::forward<EventT>(event));
+	}
+
+	/**
+	 * @brief Enqueue an event to the calling thread's own buffer, to be dispatched later
+	 *
+	 * @details See enqueue_local(EventT&&)
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam ArgsT
+	 *
+	 * @param args The arguments requires to construct an instance of this event
+	 */
+	template<typename EventT, typename... ArgsT>
+	requires std::constructible_from<EventT, ArgsT...>
+	auto enqueue_local(ArgsT&&... args) -> void {
+		get_or_create_dispatcher<EventT>().enqueue_local(std::forward<ArgsT>(args)...);
+	}
+
+	/**
+	 * @brief Enqueue an event to be dispatched later, or merge it into a pending event with the same key. A merged
+	 *        event keeps the position of the pending event, so only the latest state per key is dispatched.
+	 *
+	 * @tparam EventT  The type of event to enqueue
+	 * @tparam KeyT
+	 * @tparam MergeT
+	 *
+	 * @param key    The key that identifies which events are coalesced. Must be hashable with std::hash.
+	 * @param event  An instance of the event to enqueue
+	 * @param merge  A function which accepts the pending event by reference and the new event by rvalue reference,
+	 *               and updates the pending event. By default, the pending event is replaced.
+	 *
+	 * @return False if the queue for this event type is full and the event was discarded
+	 */
+	template<typename EventT, typename KeyT, typename MergeT = detail::replace_event>
+	requires std::invocable<MergeT&, EventT&, EventT&&>
+	auto enqueue_coalesced(KeyT const& key, EventT event, MergeT merge = {}) -> bool {
+		return get_or_create_dispatcher<EventT>().enqueue_coalesced(key, std::move(event), merge);
 	}
 
 	/**
@@ -327,14 +617,120 @@ public:
 		get_or_create_dispatcher<EventT>().send(std::forward<RangeT>(range));
 	}
 
+	/**
+	 * @brief Get a channel for an event type. A channel can enqueue and send events of that type without looking up
+	 *        the event type or locking the dispatcher map on every call.
+	 *
+	 * @tparam EventT  The type of event the channel handles
+	 *
+	 * @return A channel that is valid for the lifetime of this event dispatcher, including after it is moved
+	 */
+	template<typename EventT>
+	[[nodiscard]]
+	auto channel() -> event_channel<detail::synchronized_discrete_event_dispatcher<EventT, AllocatorT>> {
+		return event_channel{get_or_create_dispatcher<EventT>()};
+	}
+
 	/// Dispatch all events in the queue
 	auto dispatch() -> void {
 		auto lock = std::shared_lock{dispatcher_mut};
-		for (auto& [type, dispatcher] : dispatchers) {
+		for (auto const& dispatcher : dispatchers) {
 			dispatcher->dispatch();
 		}
 	}
 
+	/**
+	 * @brief Dispatch all events in the queue, dispatching independent event types concurrently on an executor
+	 *
+	 * @details Each event type is dispatched by one thread at a time, so the callbacks of one event type are still
+	 *          invoked in order, but callbacks of different event types may run at the same time. Event types ordered
+	 *          with @ref add_dispatch_dependency are dispatched in that order. The calling thread dispatches event
+	 *          types too until every event type has been dispatched, so this function doesn't depend on the executor
+	 *          being run by other threads. It may be called from a task running on the executor itself.
+	 *
+	 *          If a callback throws, event types which haven't started dispatching yet are skipped and keep their
+	 *          events, and the first exception is rethrown once the other event types have finished.
+	 *
+	 * @param executor  An ASIO executor or execution context, such as a thread pool, to dispatch event types on
+	 */
+	template<detail::executor_or_context ExecutorT>
+	auto parallel_dispatch(ExecutorT&& executor) -> void {
+		auto lock = std::shared_lock{dispatcher_mut};
+		detail::parallel_dispatch(dispatchers, dispatch_order, executor, allocator);
+	}
+
+	/**
+	 * @brief Require events of one type to be dispatched after events of another type by @ref parallel_dispatch. The
+	 *        order has no effect on @ref dispatch, which dispatches each event type in turn.
+	 *
+	 * @tparam EventT       The type of event to dispatch later
+	 * @tparam DependencyT  The type of event which must be dispatched first
+	 *
+	 * @return False, and nothing is changed, if the order would contradict previously added dependencies
+	 */
+	template<typename EventT, typename DependencyT>
+	auto add_dispatch_dependency() -> bool {
+		auto& dependent = get_or_create_dispatcher<EventT>();
+		auto& dependency = get_or_create_dispatcher<DependencyT>();
+
+		auto lock = std::scoped_lock{dispatcher_mut};
+		return dispatch_order.add_edge(position_of(dependency), position_of(dependent));
+	}
+
+	/**
+	 * @brief Dispatch at most a number of enqueued events. Events that don't fit in the budget stay in the queue, in
+	 *        order, and are dispatched first by the next call. Each call starts with the event type after the one
+	 *        where the previous call ran out, so that a busy event type can't starve the others.
+	 *
+	 * @param max_events  The maximum number of events to dispatch
+	 *
+	 * @return The number of events dispatched
+	 */
+	auto dispatch_n(size_t max_events) -> size_t {
+		auto budget = detail::dispatch_budget{max_events};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
+	/**
+	 * @brief Dispatch enqueued events until a time budget runs out. The budget is checked before each event, so a slow
+	 *        callback can overrun it. Events that weren't dispatched are resumed by the next call, like
+	 *        @ref dispatch_n.
+	 *
+	 * @param duration  The time budget
+	 *
+	 * @return The number of events dispatched
+	 */
+	template<typename RepT, typename PeriodT>
+	auto dispatch_for(std::chrono::duration<RepT, PeriodT> duration) -> size_t {
+		using clock_type = detail::dispatch_budget::clock_type;
+
+		auto budget = detail::dispatch_budget{clock_type::now() + std::chrono::ceil<clock_type::duration>(duration)};
+		dispatch_budgeted(budget);
+		return budget.dispatched();
+	}
+
+	/**
+	 * @brief Limit the number of pending events of a specific type. Events which are already pending are kept, even
+	 *        if there are more than the new capacity.
+	 *
+	 * @details Unbounded event types are enqueued without locking, so an enqueue() of this event type that races with
+	 *          this call may return true before the capacity applies, and the capacity and overflow policy are then
+	 *          applied when the event is collected at the next dispatch. Such an event can still be discarded after it
+	 *          was reported as accepted. It is counted by @ref dropped_count unless the policy is
+	 *          overflow_policy::reject. Set the capacity before other threads enqueue events of this type to avoid
+	 *          this.
+	 *
+	 * @tparam EventT  The type of event to limit
+	 *
+	 * @param capacity  The maximum number of pending events, or 0 for no limit
+	 * @param policy    What to do with an event that is enqueued while the queue is full
+	 */
+	template<typename EventT>
+	auto set_queue_capacity(size_t capacity, overflow_policy policy = overflow_policy::drop_newest) -> void {
+		get_or_create_dispatcher<EventT>().set_capacity(capacity, policy);
+	}
+
 	/**
 	 * @brief Get the number of enqueued events for a specific event type or for all events
 	 *
@@ -349,52 +745,97 @@ public:
 		auto lock = std::scoped_lock{dispatcher_mut};
 
 		if constexpr (std::same_as<void, EventT>) {
-			auto sizes = std::views::values(dispatchers) | std::views::transform([](auto const& ptr) { return ptr->size(); });
+			auto sizes = dispatchers | std::views::transform([](auto const& ptr) { return ptr->size(); });
 			return std::accumulate(std::ranges::begin(sizes), std::ranges::end(sizes), 0ull);
 		}
 
-		auto const key = std::type_index{typeid(EventT)};
+		if (auto* const dispatcher = dispatchers.find(detail::type_id<EventT>())) {
+			return dispatcher->size();
+		}
+
+		return 0;
+	}
 
-		if (auto it = dispatchers.find(key); it != dispatchers.end()) {
-			return it->second->size();
+	/**
+	 * @brief Get the number of events that were discarded because their queue was full, for a specific event type or
+	 *        for all events
+	 *
+	 * @tparam EventT  The type of event to get the count of. Leave default (void) to obtain the total number of
+	 *                 dropped events.
+	 *
+	 * @return The number of dropped events
+	 */
+	template<typename EventT = void>
+	[[nodiscard]]
+	auto dropped_count() const -> size_t {
+		auto lock = std::scoped_lock{dispatcher_mut};
+
+		if constexpr (std::same_as<void, EventT>) {
+			auto counts = dispatchers | std::views::transform([](auto const& ptr) { return ptr->dropped(); });
+			return std::accumulate(std::ranges::begin(counts), std::ranges::end(counts), 0ull);
+		}
+
+		if (auto* const dispatcher = dispatchers.find(detail::type_id<EventT>())) {
+			return dispatcher->dropped();
 		}
 
 		return 0;
 	}
 
 private:
+	// Dispatch each event type in turn until the budget runs out, starting after the type where the last budgeted
+	// dispatch ran out
+	auto dispatch_budgeted(detail::dispatch_budget& budget) -> void {
+		auto lock = std::shared_lock{dispatcher_mut};
+		auto const count = dispatchers.size();
+		auto const start = next_dispatcher.load(std::memory_order_relaxed);
+
+		for (size_t i = 0; i < count; ++i) {
+			auto const position = (start + i) % count;
+			dispatchers[position].dispatch(budget);
+
+			if (budget.exhausted()) {
+				next_dispatcher.store((position + 1) % count, std::memory_order_relaxed);
+				break;
+			}
+		}
+	}
+
+	// Get the position of a dispatcher in creation order. The dispatcher must be in the table.
+	[[nodiscard]]
+	auto position_of(generic_dispatcher const& dispatcher) const noexcept -> size_t {
+		auto const it = std::ranges::find_if(dispatchers, [&](auto const& ptr) { return ptr.get() == &dispatcher; });
+		return static_cast<size_t>(std::ranges::distance(dispatchers.begin(), it));
+	}
+
 	template<typename EventT>
 	auto get_or_create_dispatcher() -> detail::synchronized_discrete_event_dispatcher<EventT, AllocatorT>& {
 		using derived_dispatcher_type = detail::synchronized_discrete_event_dispatcher<EventT, AllocatorT>;
 
-		auto const key = std::type_index{typeid(EventT)};
-
-		// Attempt to find an existing dispatcher
-		{
-			auto lock = std::shared_lock{dispatcher_mut};
+		auto const id = detail::type_id<EventT>();
 
-			if (auto it = dispatchers.find(key); it != dispatchers.end()) {
-				return static_cast<derived_dispatcher_type&>(*(it->second));
-			}
+		// Existing dispatchers are found without locking, since the table is insert-only
+		if (auto* const dispatcher = dispatchers.find(id)) {
+			return static_cast<derived_dispatcher_type&>(*dispatcher);
 		}
 
 		// If the dispatcher didn't exist, then acquire an exclusive lock and create it.
 		auto lock = std::unique_lock{dispatcher_mut};
 
-		auto const [iter, inserted] = dispatchers.try_emplace(key);
-
-		// Check if it actually was created since two threads could get to the point where they try
-		// to acquire an exclusive lock.
-		if (inserted) {
-			iter->second = std::allocate_shared<derived_dispatcher_type>(allocator, allocator);
+		// Check again since two threads could get to the point where they try to acquire an exclusive lock.
+		if (auto* const dispatcher = dispatchers.find(id)) {
+			return static_cast<derived_dispatcher_type&>(*dispatcher);
 		}
 
-		return static_cast<derived_dispatcher_type&>(*(iter->second));
+		return static_cast<derived_dispatcher_type&>(dispatchers.insert(id, std::allocate_shared<derived_dispatcher_type>(allocator, queue_policy, allocator)));
 	}
 
 	AllocatorT allocator;
-	dispatcher_map_type dispatchers{allocator};
+	shrink_policy queue_policy;
+	dispatcher_table_type dispatchers{allocator};
+	dispatch_graph_type dispatch_order{allocator};
 	mutable std::shared_mutex dispatcher_mut;
+	std::atomic<size_t> next_dispatcher = 0;
 };
 
 
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+
+namespace events {
+
+namespace detail {
+class frame_scope;
+}
+
+
+/**
+ * @brief A memory resource for event payloads that is scoped to a dispatch cycle. Memory is bump-allocated, never
+ *        freed individually, and released all at once when it can no longer be referenced by an enqueued event.
+ *
+ * @details An arena is attached to a single event dispatcher, whose dispatch() function starts a new frame. Memory
+ *          allocated during a frame remains valid until the end of the next dispatch, which lets events enqueued
+ *          during a dispatch outlive it. An event must therefore be enqueued before the next dispatch starts, and
+ *          must not be kept after it has been dispatched. If a dispatch stops before dispatching every event, such as
+ *          a budgeted dispatch or one interrupted by an exception, the next frame is delayed until a later dispatch
+ *          completes.
+ *
+ *          The memory of each frame is kept for reuse. If a frame needed more than one block, its blocks are merged
+ *          into a single block when the frame is reused, so a steady workload stops allocating from the upstream
+ *          resource. The arena is not thread-safe.
+ *
+ *          Events use the arena by storing allocator-aware members, such as std::pmr::string, that were constructed
+ *          with the arena's allocator.
+ */
+class frame_arena final : public std::pmr::memory_resource {
+	struct block_header {
+		block_header* next;
+		size_t size;  //in bytes, including the header
+	};
+
+	struct frame {
+		block_header* blocks = nullptr;
+		std::byte* cursor = nullptr;
+		std::byte* end = nullptr;
+		size_t total = 0;  //total size of all blocks, in bytes
+	};
+
+	static constexpr size_t min_block_size = 4096;
+
+public:
+	frame_arena() noexcept : frame_arena(std::pmr::get_default_resource()) {
+	}
+
+	/**
+	 * @param upstream_resource   The resource that blocks are allocated from
+	 * @param initial_block_size  The size of the first block of each frame, in bytes. Allocated on first use.
+	 */
+	explicit frame_arena(std::pmr::memory_resource* upstream_resource, size_t initial_block_size = min_block_size) noexcept :
+		upstream(upstream_resource),
+		initial_size(initial_block_size) {
+	}
+
+	frame_arena(frame_arena const&) = delete;
+	frame_arena(frame_arena&&) = delete;
+
+	~frame_arena() override {
+		release();
+	}
+
+	auto operator=(frame_arena const&) -> frame_arena& = delete;
+	auto operator=(frame_arena&&) -> frame_arena& = delete;
+
+	/// Get an allocator that allocates from the current frame
+	[[nodiscard]]
+	auto get_allocator() noexcept -> std::pmr::polymorphic_allocator<std::byte> {
+		return std::pmr::polymorphic_allocator<std::byte>{this};
+	}
+
+	/// Get the total size of the blocks held by the arena, in bytes
+	[[nodiscard]]
+	auto capacity_bytes() const noexcept -> size_t {
+		return frames[0].total + frames[1].total;
+	}
+
+	/**
+	 * @brief Return all memory to the upstream resource
+	 *
+	 * @details Any memory allocated from the arena, including for events which are still enqueued, is invalidated.
+	 */
+	auto release() noexcept -> void {
+		for (auto& f : frames) {
+			free_blocks(f);
+		}
+	}
+
+private:
+	friend class detail::frame_scope;
+
+	// Start a new frame, reusing the memory of the frame before the current one
+	auto advance() -> void {
+		current ^= 1;
+		reset(frames[current]);
+	}
+
+	auto do_allocate(size_t bytes, size_t alignment) -> void* override {
+		auto& f = frames[current];
+
+		if (auto* const ptr = bump(f, bytes, alignment)) {
+			return ptr;
+		}
+
+		add_block(f, std::max(bytes + alignment, f.total));
+
+		auto* const ptr = bump(f, bytes, alignment);
+		if (!ptr) {
+			throw std::bad_alloc{};
+		}
+		return ptr;
+	}
+
+	auto do_deallocate(void* /*ptr*/, size_t /*bytes*/, size_t /*alignment*/) -> void override {
+		// Memory is released when its frame is reused
+	}
+
+	[[nodiscard]]
+	auto do_is_equal(std::pmr::memory_resource const& other) const noexcept -> bool override {
+		return this == &other;
+	}
+
+	[[nodiscard]]
+	static auto bump(frame& f, size_t bytes, size_t alignment) noexcept -> void* {
+		if (!f.cursor) {
+			return nullptr;
+		}
+
+		void* ptr = f.cursor;
+		auto space = static_cast<size_t>(f.end - f.cursor);
+
+		if (!std::align(alignment, bytes, ptr, space)) {
+			return nullptr;
+		}
+
+		f.cursor = static_cast<std::byte*>(ptr) + bytes;
+		return ptr;
+	}
+
+	// Allocate a block with room for at least the given number of bytes, and make it the current block of the frame
+	auto add_block(frame& f, size_t min_bytes) -> void {
+		auto const size = std::max(min_bytes + sizeof(block_header), initial_size);
+		auto* const header = ::new (upstream->allocate(size, alignof(std::max_align_t))) block_header{f.blocks, size};
+
+		f.blocks = header;
+		f.cursor = reinterpret_cast<std::byte*>(header + 1);  //NOLINT(*-reinterpret-cast)
+		f.end = reinterpret_cast<std::byte*>(header) + size;  //NOLINT(*-reinterpret-cast)
+		f.total += size;
+	}
+
+	// Make all of a frame's memory available again. Multiple blocks are merged into one of their combined size.
+	auto reset(frame& f) -> void {
+		if (!f.blocks) {
+			return;
+		}
+
+		if (f.blocks->next) {
+			auto const total = f.total;
+			free_blocks(f);
+			add_block(f, total - sizeof(block_header));
+			return;
+		}
+
+		f.cursor = reinterpret_cast<std::byte*>(f.blocks + 1);  //NOLINT(*-reinterpret-cast)
+	}
+
+	auto free_blocks(frame& f) noexcept -> void {
+		while (f.blocks) {
+			auto* const next = f.blocks->next;
+			upstream->deallocate(f.blocks, f.blocks->size, alignof(std::max_align_t));
+			f.blocks = next;
+		}
+
+		f = frame{};
+	}
+
+	std::pmr::memory_resource* upstream;
+	size_t initial_size;
+
+	std::array<frame, 2> frames;
+	size_t current = 0;
+
+	// The number of dispatches in progress. Only the outermost dispatch starts a new frame.
+	size_t dispatch_depth = 0;
+
+	// True if the last dispatch left events from before it started undispatched, which could still refer to the
+	// previous frame. The next dispatch won't start a new frame until they have been dispatched.
+	bool incomplete = false;
+};
+
+
+namespace detail {
+
+/// Starts a new frame of a @ref frame_arena for the duration of a dispatch, unless a dispatch is already in progress
+class [[nodiscard]] frame_scope {
+public:
+	explicit frame_scope(frame_arena* frame_source) : arena(frame_source) {
+		if (arena) {
+			outermost = (arena->dispatch_depth == 0);
+
+			if (outermost && !arena->incomplete) {
+				arena->advance();
+			}
+			++arena->dispatch_depth;
+		}
+	}
+
+	frame_scope(frame_scope const&) = delete;
+	frame_scope(frame_scope&&) = delete;
+
+	~frame_scope() {
+		if (arena) {
+			--arena->dispatch_depth;
+
+			// A dispatch that was interrupted by an exception may not have reached every event type
+			if (outermost) {
+				arena->incomplete = !complete || std::uncaught_exceptions() > exceptions;
+			}
+		}
+	}
+
+	auto operator=(frame_scope const&) -> frame_scope& = delete;
+	auto operator=(frame_scope&&) -> frame_scope& = delete;
+
+	/// Record that the dispatch stopped before dispatching every event that was enqueued when it started
+	auto set_incomplete() noexcept -> void {
+		complete = false;
+	}
+
+private:
+	frame_arena* arena;
+	int exceptions = std::uncaught_exceptions();
+	bool outermost = false;
+	bool complete = true;
+};
+
+}  //namespace detail
+}  //namespace events
@@ -3,22 +3,27 @@
 #include <algorithm>
 #include <cassert>
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <span>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
-#include <plf_colony.h>
-
 #include <boost/asio.hpp>
 #include <boost/asio/experimental/parallel_group.hpp>
 
 #include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/publish_arg.hpp>
+#include <events/small_function.hpp>
 #include <events/detail/parallel_publish.hpp>
+#include <events/signal_handler/callback_storage.hpp>
 
 
 // NOLINTBEGIN(cppcoreguidelines-prefer-member-initializer,hicpp-noexcept-move,performance-noexcept-move-constructor)
@@ -26,7 +31,7 @@
 namespace events {
 
 
-template<typename FunctionT, typename ExecutorT, typename AllocatorT>
+template<typename FunctionT, typename ExecutorT, typename AllocatorT, typename CallbackT = std::function<FunctionT>>
 class async_signal_handler;
 
 
@@ -35,21 +40,24 @@ class async_signal_handler;
  *        Callbacks that don't finish before a new signal is published will still be invoked. An ASIO completion token
  *        may optionally be provided when publishing a signal, which will be invoked once all callbacks have completed.
  *        If the signal returns values, these will be passed to the completion token.
+ *
+ * @tparam CallbackT  The wrapper each callback is stored in. See @ref signal_handler.
  */
-template<typename ReturnT, typename... ArgsT, typename ExecutorT, typename AllocatorT>
-class [[nodiscard]] async_signal_handler<ReturnT(ArgsT...), ExecutorT, AllocatorT> {
+template<typename ReturnT, typename... ArgsT, typename ExecutorT, typename AllocatorT, typename CallbackT>
+class [[nodiscard]] async_signal_handler<ReturnT(ArgsT...), ExecutorT, AllocatorT, CallbackT> {
 public:
 	using allocator_type = AllocatorT;
 	using executor_type = ExecutorT;
 	using function_type = ReturnT(ArgsT...);
+	using callback_type = CallbackT;
 	using completion_type = std::conditional_t<std::is_same_v<void, ReturnT>, void(), void(std::vector<ReturnT>)>;
 
 private:
 	using alloc_traits = std::allocator_traits<AllocatorT>;
 
-	using element_type = std::shared_ptr<std::function<function_type>>;
-	using container_allocator_type = typename alloc_traits::template rebind_alloc<element_type>;
-	using container_type = plf::colony<element_type, container_allocator_type>;
+	using stored_callback_type = detail::publish_callback_t<CallbackT>;
+	using element_type = std::shared_ptr<stored_callback_type>;
+	using container_type = detail::colony_callback_storage<element_type, AllocatorT>;
 
 public:
 	async_signal_handler(ExecutorT const& exec) : executor(exec) {
@@ -193,13 +201,45 @@ public:
 	 */
 	template<typename FunctionT>
 	auto connect(FunctionT&& func) -> connection {
+		auto callback_ptr = std::allocate_shared<stored_callback_type>(allocator, std::forward<FunctionT>(func));
+
 		auto lock = std::unique_lock{callback_mut};
-		auto const it = callbacks.insert(std::allocate_shared<std::function<function_type>>(allocator, std::forward<FunctionT>(func)));
+		auto const key = callbacks.emplace(std::move(callback_ptr));
 		lock.unlock();
 
-		return connection{[this, ptr = &(*it)] {
-			this->disconnect(ptr);
-		}};
+		return connection{this, &disconnect, key.index, key.generation};
+	}
+
+	/**
+	 * @brief Register a member function that will be invoked on an object when the signal is fired
+	 *
+	 * @details The callback holds nothing but the object pointer, so it fits in the inline buffer of std::function
+	 *          or @ref small_function and connecting doesn't allocate. It is still invoked through the callback
+	 *          wrapper, like any other callback. The object must outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, ArgsT...>
+	auto connect(ObjectT* instance) -> connection {
+		return connect(detail::member_delegate<Candidate, ObjectT>{instance});
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when the signal is fired
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), ArgsT...>
+	auto connect() -> connection {
+		return connect(detail::function_delegate<Candidate>{});
 	}
 
 	/**
@@ -207,7 +247,7 @@ public:
 	 *
 	 * @param args The signal arguments
 	 */
-	auto publish(ArgsT... args) -> void requires std::same_as<void, ReturnT>
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> void requires std::same_as<void, ReturnT>
 	{
 		auto lock = std::shared_lock{callback_mut};
 
@@ -223,7 +263,7 @@ public:
 	 *
 	 * @return The callback results
 	 */
-	auto publish(ArgsT... args) -> std::vector<ReturnT> requires(!std::same_as<void, ReturnT>)
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> std::vector<ReturnT> requires(!std::same_as<void, ReturnT>)
 	{
 		auto lock = std::shared_lock{callback_mut};
 
@@ -237,19 +277,124 @@ public:
 		return results;
 	}
 
+	/**
+	 * @brief Fire the signal synchronously, writing the callback results into a caller-provided buffer
+	 *
+	 * @details Every callback is invoked, but only as many results as fit in the buffer are written. The rest are
+	 *          discarded, which can be detected by comparing the size of the returned span to @ref size.
+	 *
+	 * @param out   The buffer to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return The part of the buffer that was written to
+	 */
+	auto publish_into(std::span<ReturnT> out, detail::publish_arg_t<ArgsT>... args) -> std::span<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto lock = std::shared_lock{callback_mut};
+
+		auto it = out.begin();
+		for (auto& callback_ptr : callbacks) {
+			if (it != out.end()) {
+				*it++ = (*callback_ptr)(args...);
+			}
+			else {
+				(*callback_ptr)(args...);
+			}
+		}
+
+		return out.first(static_cast<size_t>(it - out.begin()));
+	}
+
+	/**
+	 * @brief Fire the signal synchronously, writing the callback results to an output iterator
+	 *
+	 * @param out   The output iterator to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return An iterator past the last result written
+	 */
+	template<std::output_iterator<ReturnT> OutputIt>
+	auto publish_into(OutputIt out, detail::publish_arg_t<ArgsT>... args) -> OutputIt
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto lock = std::shared_lock{callback_mut};
+
+		for (auto& callback_ptr : callbacks) {
+			*out++ = (*callback_ptr)(args...);
+		}
+
+		return out;
+	}
+
+	/**
+	 * @brief Fire the signal synchronously, folding the callback results into a single value as they are produced
+	 *
+	 * @details Equivalent to std::accumulate over the results of @ref publish, without collecting them first. Each
+	 *          callback result is combined with the accumulated value as op(std::move(value), result).
+	 *
+	 * @param init  The initial value
+	 * @param op    A binary operation that combines the accumulated value with a callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The accumulated value, or init if no callbacks are connected
+	 */
+	template<typename T, typename BinaryOpT>
+	requires std::convertible_to<std::invoke_result_t<BinaryOpT&, T, ReturnT>, T>
+	auto publish_reduce(T init, BinaryOpT op, detail::publish_arg_t<ArgsT>... args) -> T
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto lock = std::shared_lock{callback_mut};
+
+		for (auto& callback_ptr : callbacks) {
+			init = op(std::move(init), (*callback_ptr)(args...));
+		}
+
+		return init;
+	}
+
+	/**
+	 * @brief Fire the signal synchronously, stopping at the first callback whose result satisfies a predicate.
+	 *        Callbacks after that one are not invoked.
+	 *
+	 * @param pred  A predicate that is tested against each callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The first result that satisfied the predicate, or std::nullopt if no result did
+	 */
+	template<std::predicate<ReturnT const&> PredicateT>
+	auto publish_until(PredicateT pred, detail::publish_arg_t<ArgsT>... args) -> std::optional<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto lock = std::shared_lock{callback_mut};
+
+		for (auto& callback_ptr : callbacks) {
+			auto result = (*callback_ptr)(args...);
+
+			if (std::invoke(pred, std::as_const(result))) {
+				return result;
+			}
+		}
+
+		return std::nullopt;
+	}
+
 	/**
 	 * @brief Fire the signal asynchronously
 	 *
+	 * @details The arguments are stored once, and shared by every callback invocation. Callbacks receive them as
+	 *          const lvalues.
+	 *
 	 * @param args The signal arguments
 	 */
 	auto async_publish(ArgsT... args) -> void {
-		auto args_tuple = std::tuple<ArgsT...>(std::forward<ArgsT>(args)...);
+		auto const args_ptr = make_shared_args(std::forward<ArgsT>(args)...);
 
 		auto lock = std::shared_lock{callback_mut};
 
 		for (auto& callback_ptr : callbacks) {
-			boost::asio::post(executor, [callback_ptr, args_tuple]() mutable {
-				(void)std::apply(*callback_ptr, std::move(args_tuple));
+			boost::asio::post(executor, [callback_ptr, args_ptr] {
+				(void)std::apply(*callback_ptr, *args_ptr);
 			});
 		}
 	}
@@ -257,24 +402,27 @@ public:
 	/**
 	 * @brief Fire the signal asynchronously and invoke a completion token when finished
 	 *
+	 * @details The arguments are stored once, and shared by every callback invocation. Callbacks receive them as
+	 *          const lvalues.
+	 *
 	 * @param args The signal arguments
 	 * @param completion A completion token that will be called when the operation completes
 	 */
 	template<typename CompletionToken>
 	auto async_publish(ArgsT... args, CompletionToken&& completion) {
-		// Store the arguments in a tuple, which will be referenced by each async operation.
-		auto args_tuple = std::tuple<ArgsT...>(std::forward<ArgsT>(args)...);
+		// Store the arguments in a single immutable tuple, which will be shared by each async operation.
+		auto const args_ptr = make_shared_args(std::forward<ArgsT>(args)...);
 
 		// This will post a function which will invoke the callback then re-add itself to the list of pending callbacks
 		// once it has completed. The actual operation is deferred to be later executed as part of a parallel_group.
-		auto post_op = [this, &args_tuple](typename container_type::reference callback_ptr) {
-			auto execute = [callback_ptr, args_tuple]() mutable {
+		auto post_op = [this, &args_ptr](element_type& callback_ptr) {
+			auto execute = [callback_ptr, args_ptr] {
 				if constexpr (std::same_as<void, ReturnT>) {
-					std::apply(*callback_ptr, std::move(args_tuple));
+					std::apply(*callback_ptr, *args_ptr);
 					return boost::asio::deferred_t::values(std::monostate{});  //needs to return a value
 				}
 				else {
-					auto result = std::apply(*callback_ptr, std::move(args_tuple));
+					auto result = std::apply(*callback_ptr, *args_ptr);
 					return boost::asio::deferred_t::values(std::move(result));
 				}
 			};
@@ -282,7 +430,7 @@ public:
 			return boost::asio::post(executor, boost::asio::deferred(std::move(execute)));
 		};
 
-		using post_op_type = decltype(post_op(std::declval<typename container_type::reference>()));
+		using post_op_type = decltype(post_op(std::declval<element_type&>()));
 		auto operations = std::vector<post_op_type>{};
 		operations.reserve(callbacks.size());
 
@@ -304,9 +452,16 @@ public:
 	}
 
 private:
-	auto disconnect(typename container_type::const_pointer pointer) -> void {
-		auto lock = std::scoped_lock{callback_mut};
-		callbacks.erase(callbacks.get_iterator(pointer));
+	// Reference arguments keep referring to the caller's objects, as they would for a synchronous publish
+	auto make_shared_args(ArgsT&&... args) const -> std::shared_ptr<std::tuple<ArgsT...> const> {
+		return std::allocate_shared<std::tuple<ArgsT...>>(allocator, std::forward<ArgsT>(args)...);
+	}
+
+	static auto disconnect(void* owner, uint32_t index, uint32_t generation) -> void {
+		auto* const self = static_cast<async_signal_handler*>(owner);
+
+		auto lock = std::scoped_lock{self->callback_mut};
+		self->callbacks.erase(detail::slot_key{index, generation});
 	}
 
 	AllocatorT allocator;
@@ -0,0 +1,628 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <plf_colony.h>
+
+#include <events/detail/slot_table.hpp>
+
+
+namespace events {
+namespace detail {
+
+/**
+ * @brief Counts the publishes iterating over a callback storage. Only tracked in debug builds, so storages that move
+ *        callbacks when connecting or disconnecting can assert that they aren't modified during a publish. Copies
+ *        start at zero, since the publish is iterating over the original.
+ */
+class publish_depth {
+public:
+	publish_depth() noexcept = default;
+	publish_depth(publish_depth const&) noexcept {
+	}
+
+	~publish_depth() = default;
+
+	auto operator=(publish_depth const&) noexcept -> publish_depth& {
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto publishing() const noexcept -> bool {
+#ifndef NDEBUG
+		return depth != 0;
+#else
+		return false;
+#endif
+	}
+
+private:
+	friend class publish_scope;
+
+#ifndef NDEBUG
+	size_t depth = 0;
+#endif
+};
+
+
+/// Marks a callback storage as being published to for as long as it is alive
+class [[nodiscard]] publish_scope {
+public:
+	publish_scope() noexcept = default;
+
+#ifndef NDEBUG
+	explicit publish_scope(publish_depth& depth_counter) noexcept : counter(&depth_counter) {
+		++depth_counter.depth;
+	}
+#else
+	explicit publish_scope(publish_depth&) noexcept {
+	}
+#endif
+
+	publish_scope(publish_scope const&) = delete;
+
+	~publish_scope() {
+#ifndef NDEBUG
+		if (counter) {
+			--counter->depth;
+		}
+#endif
+	}
+
+	auto operator=(publish_scope const&) -> publish_scope& = delete;
+
+#ifndef NDEBUG
+private:
+	publish_depth* counter = nullptr;
+#endif
+};
+
+
+/**
+ * @brief Callback storage backed by a plf::colony. Callbacks never move once inserted, and erasing one leaves a gap
+ *        that is skipped during iteration and reused by a later insertion. A slot table maps keys to callbacks.
+ */
+template<typename T, typename AllocatorT>
+class colony_callback_storage {
+	using allocator_traits = std::allocator_traits<AllocatorT>;
+	using container_allocator_type = typename allocator_traits::template rebind_alloc<T>;
+	using container_type = plf::colony<T, container_allocator_type>;
+
+	using key_table_type = slot_table<typename container_type::const_pointer, AllocatorT>;
+
+public:
+	using value_type = T;
+	using allocator_type = container_allocator_type;
+	using key_type = slot_key;
+	using iterator = typename container_type::iterator;
+	using const_iterator = typename container_type::const_iterator;
+
+	colony_callback_storage() = default;
+
+	explicit colony_callback_storage(AllocatorT const& alloc) : values(container_allocator_type{alloc}), keys(alloc) {
+	}
+
+	// The keys of the copied callbacks only belong to the other container, so they aren't copied
+	colony_callback_storage(colony_callback_storage const& other) : values(other.values) {
+	}
+
+	colony_callback_storage(colony_callback_storage const& other, AllocatorT const& alloc) :
+		values(other.values, container_allocator_type{alloc}),
+		keys(alloc) {
+	}
+
+	colony_callback_storage(colony_callback_storage&&) noexcept = default;
+
+	// The callbacks may be relocated if the allocators differ, so the other container's keys are discarded
+	colony_callback_storage(colony_callback_storage&& other, AllocatorT const& alloc) :
+		values(std::move(other.values), container_allocator_type{alloc}),
+		keys(alloc) {
+		other.keys.clear();
+	}
+
+	~colony_callback_storage() = default;
+
+	auto operator=(colony_callback_storage const& other) -> colony_callback_storage& {
+		if (&other != this) {
+			values = other.values;
+			keys.clear();
+		}
+		return *this;
+	}
+
+	auto operator=(colony_callback_storage&&) noexcept -> colony_callback_storage& = default;
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type {
+		return values.get_allocator();
+	}
+
+	template<typename... ArgsT>
+	auto emplace(ArgsT&&... args) -> key_type {
+		auto const it = values.emplace(std::forward<ArgsT>(args)...);
+		return keys.insert(&(*it));
+	}
+
+	/// Erase the callback a key refers to. Does nothing if the key is no longer valid.
+	auto erase(key_type key) -> void {
+		if (auto const* pointer = keys.find(key)) {
+			values.erase(values.get_iterator(*pointer));
+			keys.erase(key);
+		}
+	}
+
+	auto reserve(size_t count) -> void {
+		values.reserve(count);
+		keys.reserve(count);
+	}
+
+	auto clear() -> void {
+		values.clear();
+		keys.clear();
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		return values.size();
+	}
+
+	[[nodiscard]]
+	auto empty() const noexcept -> bool {
+		return values.empty();
+	}
+
+	/// Callbacks never move, so connecting and disconnecting during a publish needs no tracking
+	[[nodiscard]]
+	auto begin_publish() noexcept -> publish_scope {
+		return publish_scope{};
+	}
+
+	[[nodiscard]] auto begin() noexcept -> iterator { return values.begin(); }
+	[[nodiscard]] auto end() noexcept -> iterator { return values.end(); }
+	[[nodiscard]] auto begin() const noexcept -> const_iterator { return values.begin(); }
+	[[nodiscard]] auto end() const noexcept -> const_iterator { return values.end(); }
+
+private:
+	container_type values;
+	key_table_type keys;
+};
+
+
+/**
+ * @brief Callback storage that keeps all callbacks packed in a vector. Erasing a callback moves the last one into its
+ *        place, so iteration is always a linear scan with no gaps. A slot table maps each key to the current position
+ *        of its callback, which keeps keys stable as callbacks are moved around.
+ *
+ * @details Since inserting and erasing move callbacks, neither may happen while a publish is iterating over the
+ *          callbacks. This is asserted in debug builds.
+ */
+template<typename T, typename AllocatorT>
+class dense_callback_storage {
+	using allocator_traits = std::allocator_traits<AllocatorT>;
+
+	using index_type = uint32_t;
+	using index_allocator_type = typename allocator_traits::template rebind_alloc<index_type>;
+	using index_container_type = std::vector<index_type, index_allocator_type>;
+
+	using value_allocator_type = typename allocator_traits::template rebind_alloc<T>;
+	using value_container_type = std::vector<T, value_allocator_type>;
+
+	using key_table_type = slot_table<index_type, AllocatorT>;
+
+public:
+	using value_type = T;
+	using allocator_type = value_allocator_type;
+	using key_type = slot_key;
+	using iterator = typename value_container_type::iterator;
+	using const_iterator = typename value_container_type::const_iterator;
+
+	dense_callback_storage() = default;
+	dense_callback_storage(dense_callback_storage const&) = default;
+	dense_callback_storage(dense_callback_storage&&) noexcept = default;
+
+	explicit dense_callback_storage(AllocatorT const& alloc) : values(alloc), value_slots(alloc), keys(alloc) {
+	}
+
+	dense_callback_storage(dense_callback_storage const& other, AllocatorT const& alloc) :
+		values(other.values, alloc),
+		value_slots(other.value_slots, alloc),
+		keys(other.keys, alloc) {
+	}
+
+	dense_callback_storage(dense_callback_storage&& other, AllocatorT const& alloc) :
+		values(std::move(other.values), alloc),
+		value_slots(std::move(other.value_slots), alloc),
+		keys(std::move(other.keys), alloc) {
+	}
+
+	~dense_callback_storage() = default;
+
+	auto operator=(dense_callback_storage const&) -> dense_callback_storage& = default;
+	auto operator=(dense_callback_storage&&) noexcept -> dense_callback_storage& = default;
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type {
+		return values.get_allocator();
+	}
+
+	template<typename... ArgsT>
+	auto emplace(ArgsT&&... args) -> key_type {
+		assert(!depth.publishing() && "Callbacks can't be connected to dense storage during a publish");
+
+		auto const index = static_cast<index_type>(values.size());
+		values.emplace_back(std::forward<ArgsT>(args)...);
+
+		auto const key = keys.insert(index);
+		value_slots.push_back(key.index);
+
+		return key;
+	}
+
+	/// Erase the callback a key refers to. Does nothing if the key is no longer valid.
+	auto erase(key_type key) -> void {
+		assert(!depth.publishing() && "Callbacks can't be disconnected from dense storage during a publish");
+
+		auto const* const index_pointer = keys.find(key);
+		if (!index_pointer) {
+			return;
+		}
+
+		auto const index = *index_pointer;
+		auto const last = static_cast<index_type>(values.size() - 1);
+
+		// Move the last callback into the erased one's place, and point its slot at the new position
+		if (index != last) {
+			values[index] = std::move(values[last]);
+			value_slots[index] = value_slots[last];
+			keys[value_slots[index]] = index;
+		}
+
+		values.pop_back();
+		value_slots.pop_back();
+		keys.erase(key);
+	}
+
+	/// Reserve space for a number of callbacks, so that connecting up to that many won't allocate
+	auto reserve(size_t count) -> void {
+		values.reserve(count);
+		value_slots.reserve(count);
+		keys.reserve(count);
+	}
+
+	auto clear() -> void {
+		values.clear();
+		value_slots.clear();
+		keys.clear();
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		return values.size();
+	}
+
+	[[nodiscard]]
+	auto empty() const noexcept -> bool {
+		return values.empty();
+	}
+
+	/// Mark the callbacks as being published to until the returned scope ends
+	[[nodiscard]]
+	auto begin_publish() noexcept -> publish_scope {
+		return publish_scope{depth};
+	}
+
+	[[nodiscard]] auto begin() noexcept -> iterator { return values.begin(); }
+	[[nodiscard]] auto end() noexcept -> iterator { return values.end(); }
+	[[nodiscard]] auto begin() const noexcept -> const_iterator { return values.begin(); }
+	[[nodiscard]] auto end() const noexcept -> const_iterator { return values.end(); }
+
+private:
+	// The packed callbacks, and the index of the slot that refers to each one
+	value_container_type values;
+	index_container_type value_slots;
+
+	// Maps a key to the index of its callback
+	key_table_type keys;
+
+	[[no_unique_address]] publish_depth depth;
+};
+
+
+/**
+ * @brief Callback storage that holds up to Capacity callbacks inline, with no allocation. Connecting more than that
+ *        moves all callbacks to a heap buffer. Callbacks are kept packed, like @ref dense_callback_storage, but
+ *        instead of a slot table each callback stores its own generation. A key holds the position of its callback
+ *        at the time it was inserted, and the callbacks are searched linearly if it has since moved. This is meant
+ *        for signals with only a handful of listeners.
+ *
+ * @details Like @ref dense_callback_storage, callbacks may not be inserted or erased while a publish is iterating
+ *          over them. This is asserted in debug builds.
+ */
+template<typename T, size_t Capacity, typename AllocatorT>
+class inline_callback_storage {
+	static_assert(Capacity > 0, "The inline capacity must be at least 1");
+
+	using allocator_traits = std::allocator_traits<AllocatorT>;
+
+	using value_allocator_type = typename allocator_traits::template rebind_alloc<T>;
+	using value_allocator_traits = std::allocator_traits<value_allocator_type>;
+
+	using generation_allocator_type = typename allocator_traits::template rebind_alloc<uint32_t>;
+	using generation_allocator_traits = std::allocator_traits<generation_allocator_type>;
+
+public:
+	using value_type = T;
+	using allocator_type = value_allocator_type;
+	using key_type = slot_key;
+	using iterator = T*;
+	using const_iterator = T const*;
+
+	inline_callback_storage() = default;
+
+	explicit inline_callback_storage(AllocatorT const& alloc) : allocator(alloc) {
+	}
+
+	inline_callback_storage(inline_callback_storage const& other) :
+		allocator(value_allocator_traits::select_on_container_copy_construction(other.allocator)) {
+		copy_from(other);
+	}
+
+	inline_callback_storage(inline_callback_storage const& other, AllocatorT const& alloc) : allocator(alloc) {
+		copy_from(other);
+	}
+
+	inline_callback_storage(inline_callback_storage&& other) noexcept : allocator(std::move(other.allocator)) {
+		move_from(other);
+	}
+
+	inline_callback_storage(inline_callback_storage&& other, AllocatorT const& alloc) : allocator(alloc) {
+		move_from(other);
+	}
+
+	~inline_callback_storage() {
+		clear();
+		deallocate();
+	}
+
+	auto operator=(inline_callback_storage const& other) -> inline_callback_storage& {
+		if (&other != this) {
+			auto const previous_generation = next_generation;
+
+			clear();
+			copy_from(other);
+			renew_generations(std::max(previous_generation, other.next_generation));
+		}
+		return *this;
+	}
+
+	auto operator=(inline_callback_storage&& other) noexcept -> inline_callback_storage& {
+		if (&other != this) {
+			auto const previous_generation = next_generation;
+
+			clear();
+			deallocate();
+			move_from(other);
+			renew_generations(std::max(previous_generation, other.next_generation));
+		}
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type {
+		return allocator;
+	}
+
+	template<typename... ArgsT>
+	auto emplace(ArgsT&&... args) -> key_type {
+		assert(!depth.publishing() && "Callbacks can't be connected to inline storage during a publish");
+
+		if (count == capacity) {
+			grow(capacity * 2);
+		}
+
+		value_allocator_traits::construct(allocator, values + count, std::forward<ArgsT>(args)...);
+		generations[count] = next_generation++;
+
+		auto const key = key_type{static_cast<uint32_t>(count), generations[count]};
+		++count;
+
+		return key;
+	}
+
+	/// Erase the callback a key refers to. Does nothing if the key is no longer valid.
+	auto erase(key_type key) -> void {
+		assert(!depth.publishing() && "Callbacks can't be disconnected from inline storage during a publish");
+
+		auto index = static_cast<size_t>(key.index);
+
+		if (index >= count || generations[index] != key.generation) {
+			index = static_cast<size_t>(std::find(generations, generations + count, key.generation) - generations);
+			if (index == count) {
+				return;
+			}
+		}
+
+		auto const last = count - 1;
+
+		if (index != last) {
+			values[index] = std::move(values[last]);
+			generations[index] = generations[last];
+		}
+
+		value_allocator_traits::destroy(allocator, values + last);
+		--count;
+	}
+
+	/// Reserve space for a number of callbacks. Reserving more than the inline capacity moves callbacks to the heap.
+	auto reserve(size_t new_capacity) -> void {
+		if (new_capacity > capacity) {
+			grow(new_capacity);
+		}
+	}
+
+	auto clear() -> void {
+		std::destroy(values, values + count);
+		count = 0;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		return count;
+	}
+
+	[[nodiscard]]
+	auto empty() const noexcept -> bool {
+		return count == 0;
+	}
+
+	[[nodiscard]]
+	auto front() noexcept -> T& {
+		assert(count > 0);
+		return *values;
+	}
+
+	/// Mark the callbacks as being published to until the returned scope ends
+	[[nodiscard]]
+	auto begin_publish() noexcept -> publish_scope {
+		return publish_scope{depth};
+	}
+
+	[[nodiscard]] auto begin() noexcept -> iterator { return values; }
+	[[nodiscard]] auto end() noexcept -> iterator { return values + count; }
+	[[nodiscard]] auto begin() const noexcept -> const_iterator { return values; }
+	[[nodiscard]] auto end() const noexcept -> const_iterator { return values + count; }
+
+private:
+	[[nodiscard]]
+	auto inline_values() noexcept -> T* {
+		return static_cast<T*>(static_cast<void*>(inline_value_buffer));
+	}
+
+	[[nodiscard]]
+	auto is_inline() const noexcept -> bool {
+		return capacity == Capacity;
+	}
+
+	// Move the callbacks to a heap buffer with room for at least new_capacity callbacks
+	auto grow(size_t new_capacity) -> void {
+		auto generation_allocator = generation_allocator_type{allocator};
+
+		auto* const new_values = value_allocator_traits::allocate(allocator, new_capacity);
+		auto* const new_generations = generation_allocator_traits::allocate(generation_allocator, new_capacity);
+
+		std::uninitialized_move(values, values + count, new_values);
+		std::copy(generations, generations + count, new_generations);
+		std::destroy(values, values + count);
+
+		deallocate();
+
+		values = new_values;
+		generations = new_generations;
+		capacity = new_capacity;
+	}
+
+	// Release the heap buffer, if any, and return to the inline buffer. Requires that there are no callbacks.
+	auto deallocate() noexcept -> void {
+		if (!is_inline()) {
+			auto generation_allocator = generation_allocator_type{allocator};
+			value_allocator_traits::deallocate(allocator, values, capacity);
+			generation_allocator_traits::deallocate(generation_allocator, generations, capacity);
+		}
+
+		values = inline_values();
+		generations = inline_generations;
+		capacity = Capacity;
+	}
+
+	// Requires that this container is empty
+	auto copy_from(inline_callback_storage const& other) -> void {
+		reserve(other.count);
+		std::uninitialized_copy(other.values, other.values + other.count, values);
+		std::copy(other.generations, other.generations + other.count, generations);
+		count = other.count;
+		next_generation = other.next_generation;
+	}
+
+	// Requires that this container is empty and holds no heap buffer
+	auto move_from(inline_callback_storage& other) -> void {
+		if (!other.is_inline() && allocator == other.allocator) {
+			values = std::exchange(other.values, other.inline_values());
+			generations = std::exchange(other.generations, other.inline_generations);
+			capacity = std::exchange(other.capacity, Capacity);
+		}
+		else {
+			reserve(other.count);
+			std::uninitialized_move(other.values, other.values + other.count, values);
+			std::copy(other.generations, other.generations + other.count, generations);
+			std::destroy(other.values, other.values + other.count);
+		}
+
+		count = std::exchange(other.count, 0);
+		next_generation = other.next_generation;
+	}
+
+	// Give every callback a generation newer than any key issued by this container or the one its callbacks came from.
+	// Both containers' counters must be passed in, since copy_from() and move_from() overwrite this one's.
+	auto renew_generations(uint32_t first_unused_generation) noexcept -> void {
+		next_generation = first_unused_generation;
+		std::generate(generations, generations + count, [this] { return next_generation++; });
+	}
+
+	[[no_unique_address]] value_allocator_type allocator;
+
+	T* values = inline_values();
+	uint32_t* generations = inline_generations;
+	size_t count = 0;
+	size_t capacity = Capacity;
+	uint32_t next_generation = 0;
+
+	[[no_unique_address]] publish_depth depth;
+
+	alignas(T) std::byte inline_value_buffer[Capacity * sizeof(T)];  //NOLINT(*-avoid-c-arrays)
+	uint32_t inline_generations[Capacity];                            //NOLINT(*-avoid-c-arrays)
+};
+
+}  //namespace detail
+
+
+/**
+ * @brief Stores the callbacks of a signal handler in a plf::colony. Connecting and disconnecting never moves other
+ *        callbacks, but iteration has to skip over the gaps left by disconnected callbacks.
+ */
+struct colony_storage {
+	template<typename T, typename AllocatorT>
+	using container = detail::colony_callback_storage<T, AllocatorT>;
+};
+
+
+/**
+ * @brief Stores the callbacks of a signal handler packed together in a vector, so publishing is a linear scan no
+ *        matter how many callbacks have been connected and disconnected. Disconnecting a callback moves the last
+ *        callback into its place, so callbacks are not invoked in the order they were connected. Unlike
+ *        @ref colony_storage, callbacks can't be connected or disconnected from inside a callback during a publish.
+ */
+struct dense_storage {
+	template<typename T, typename AllocatorT>
+	using container = detail::dense_callback_storage<T, AllocatorT>;
+};
+
+
+/**
+ * @brief Stores up to Capacity callbacks inside the signal handler itself, only allocating once more callbacks than
+ *        that are connected. Publishing a signal with a single callback takes a dedicated fast path. Disconnecting
+ *        searches the callbacks linearly, so this policy is meant for signals with a handful of listeners. Like
+ *        @ref dense_storage, callbacks can't be connected or disconnected from inside a callback during a publish.
+ */
+template<size_t Capacity>
+struct inline_storage {
+	template<typename T, typename AllocatorT>
+	using container = detail::inline_callback_storage<T, Capacity, AllocatorT>;
+};
+
+}  //namespace events
@@ -1,18 +1,31 @@
 #pragma once
 
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <ranges>
-
-#include <plf_colony.h>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 #include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/publish_arg.hpp>
+#include <events/signal_handler/callback_storage.hpp>
+#include <events/small_function.hpp>
 
 
 namespace events {
 
-template<typename FunctionT, typename = std::allocator<void>>
+template<
+	typename FunctionT,
+	typename = std::allocator<void>,
+	typename = std::function<FunctionT>,
+	typename = colony_storage
+>
 class signal_handler;
 
 
@@ -20,18 +33,28 @@ class signal_handler;
  * @brief A signal handler allows callbacks to be registered which will be invoked when the signal is published.
  *        Signals can have any function signature, and can also have return values, which will be collected and
  *        returned to the publisher of the signal.
+ *
+ * @tparam CallbackT  The wrapper each callback is stored in. Defaults to std::function. A @ref small_function can be
+ *                    used instead to store callbacks inline without allocating, in which case the signal handler is
+ *                    move-only. The wrapper is rebound so that value arguments are received by const reference,
+ *                    e.g. std::function<void(T)> stores std::function<void(T const&)>, and publishing a signal
+ *                    doesn't copy its arguments once per callback.
+ * @tparam StorageT   The container policy used to store callbacks. Defaults to @ref colony_storage. See
+ *                    @ref dense_storage for an alternative that is faster to publish to, and @ref inline_storage
+ *                    for signals that only have a few listeners. Unlike the default, those two policies don't allow
+ *                    connecting or disconnecting from inside a callback while the signal is being published.
  */
-template<typename ReturnT, typename... ArgsT, typename AllocatorT>
-class [[nodiscard]] signal_handler<ReturnT(ArgsT...), AllocatorT> {
+template<typename ReturnT, typename... ArgsT, typename AllocatorT, typename CallbackT, typename StorageT>
+class [[nodiscard]] signal_handler<ReturnT(ArgsT...), AllocatorT, CallbackT, StorageT> {
 public:
 	using function_type = ReturnT(ArgsT...);
 	using allocator_type = AllocatorT;
+	using callback_type = CallbackT;
+	using storage_type = StorageT;
 
 private:
-	using alloc_traits = std::allocator_traits<AllocatorT>;
-	using element_type = std::function<function_type>;
-	using container_allocator_type = typename alloc_traits::template rebind_alloc<element_type>;
-	using container_type = plf::colony<element_type, container_allocator_type>;
+	using element_type = detail::publish_callback_t<CallbackT>;
+	using container_type = typename StorageT::template container<element_type, AllocatorT>;
 
 public:
 	signal_handler() = default;
@@ -95,6 +118,12 @@ public:
 		return callbacks.size();
 	}
 
+	/// Reserve space for a number of callbacks. Depending on the storage policy, this may allow connecting up to that
+	/// many callbacks without allocating.
+	auto reserve(size_t count) -> void {
+		callbacks.reserve(count);
+	}
+
 	/// Disconnect all callbacks
 	auto disconnect_all() -> void {
 		callbacks.clear();
@@ -111,8 +140,40 @@ public:
 	 */
 	template<std::invocable<ArgsT...> FunctionT>
 	auto connect(FunctionT&& callback) -> connection {
-		auto const it = callbacks.insert(std::forward<FunctionT>(callback));
-		return connection{[this, ptr = &(*it)] { disconnect(ptr); }};
+		auto const key = callbacks.emplace(std::forward<FunctionT>(callback));
+		return connection{this, &disconnect, key.index, key.generation};
+	}
+
+	/**
+	 * @brief Register a member function that will be invoked on an object when the signal is fired
+	 *
+	 * @details The callback holds nothing but the object pointer, so it fits in the inline buffer of std::function
+	 *          or @ref small_function and connecting doesn't allocate. It is still invoked through the callback
+	 *          wrapper, like any other callback. The object must outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, ArgsT...>
+	auto connect(ObjectT* instance) -> connection {
+		return connect(detail::member_delegate<Candidate, ObjectT>{instance});
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when the signal is fired
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), ArgsT...>
+	auto connect() -> connection {
+		return connect(detail::function_delegate<Candidate>{});
 	}
 
 	/**
@@ -120,13 +181,44 @@ public:
 	 *
 	 * @param args The signal arguments
 	 */
-	auto publish(ArgsT... args) -> void requires std::same_as<void, ReturnT>
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> void requires std::same_as<void, ReturnT>
 	{
+		auto const scope = callbacks.begin_publish();
+
+		// Storage policies that provide direct access to their first callback get a fast path for the common case of a
+		// single listener.
+		if constexpr (requires { callbacks.front(); }) {
+			if (callbacks.size() == 1) {
+				callbacks.front()(args...);
+				return;
+			}
+		}
+
 		for (auto& callback : callbacks) {
 			callback(args...);
 		}
 	}
 
+	/**
+	 * @brief Fire the signal once for each set of arguments in a batch
+	 *
+	 * @details Callbacks are invoked callback-major: each callback is invoked with every set of arguments before the
+	 *          next callback is invoked. This keeps a single callback's code and data hot for the whole batch, but
+	 *          interleaves callbacks differently than calling @ref publish for each set.
+	 *
+	 * @param batch  The argument sets to publish
+	 */
+	auto publish_batch(std::span<std::tuple<ArgsT...> const> batch) -> void requires std::same_as<void, ReturnT>
+	{
+		auto const scope = callbacks.begin_publish();
+
+		for (auto& callback : callbacks) {
+			for (auto const& args : batch) {
+				std::apply(callback, args);
+			}
+		}
+	}
+
 	/**
 	 * @brief Fire the signal
 	 *
@@ -134,8 +226,10 @@ public:
 	 *
 	 * @return The callback results
 	 */
-	auto publish(ArgsT... args) -> std::vector<ReturnT> requires(!std::same_as<void, ReturnT>)
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> std::vector<ReturnT> requires(!std::same_as<void, ReturnT>)
 	{
+		auto const scope = callbacks.begin_publish();
+
 		auto results = std::vector<ReturnT>{};
 		results.reserve(callbacks.size());
 
@@ -146,6 +240,108 @@ public:
 		return results;
 	}
 
+	/**
+	 * @brief Fire the signal, folding the callback results into a single value as they are produced
+	 *
+	 * @details Equivalent to std::accumulate over the results of @ref publish, without collecting them first. Each
+	 *          callback result is combined with the accumulated value as op(std::move(value), result).
+	 *
+	 * @param init  The initial value
+	 * @param op    A binary operation that combines the accumulated value with a callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The accumulated value, or init if no callbacks are connected
+	 */
+	template<typename T, typename BinaryOpT>
+	requires std::convertible_to<std::invoke_result_t<BinaryOpT&, T, ReturnT>, T>
+	auto publish_reduce(T init, BinaryOpT op, detail::publish_arg_t<ArgsT>... args) -> T
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto const scope = callbacks.begin_publish();
+
+		for (auto& callback : callbacks) {
+			init = op(std::move(init), callback(args...));
+		}
+
+		return init;
+	}
+
+	/**
+	 * @brief Fire the signal, stopping at the first callback whose result satisfies a predicate. Callbacks after that
+	 *        one are not invoked.
+	 *
+	 * @param pred  A predicate that is tested against each callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The first result that satisfied the predicate, or std::nullopt if no result did
+	 */
+	template<std::predicate<ReturnT const&> PredicateT>
+	auto publish_until(PredicateT pred, detail::publish_arg_t<ArgsT>... args) -> std::optional<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto const scope = callbacks.begin_publish();
+
+		for (auto& callback : callbacks) {
+			auto result = callback(args...);
+
+			if (std::invoke(pred, std::as_const(result))) {
+				return result;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	/**
+	 * @brief Fire the signal, writing the callback results into a caller-provided buffer
+	 *
+	 * @details Every callback is invoked, but only as many results as fit in the buffer are written. The rest are
+	 *          discarded, which can be detected by comparing the size of the returned span to @ref size.
+	 *
+	 * @param out   The buffer to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return The part of the buffer that was written to
+	 */
+	auto publish_into(std::span<ReturnT> out, detail::publish_arg_t<ArgsT>... args) -> std::span<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto const scope = callbacks.begin_publish();
+
+		auto it = out.begin();
+		for (auto& callback : callbacks) {
+			if (it != out.end()) {
+				*it++ = callback(args...);
+			}
+			else {
+				callback(args...);
+			}
+		}
+
+		return out.first(static_cast<size_t>(it - out.begin()));
+	}
+
+	/**
+	 * @brief Fire the signal, writing the callback results to an output iterator
+	 *
+	 * @param out   The output iterator to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return An iterator past the last result written
+	 */
+	template<std::output_iterator<ReturnT> OutputIt>
+	auto publish_into(OutputIt out, detail::publish_arg_t<ArgsT>... args) -> OutputIt
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto const scope = callbacks.begin_publish();
+
+		for (auto& callback : callbacks) {
+			*out++ = callback(args...);
+		}
+
+		return out;
+	}
+
 	/**
 	 * @brief Fire the signal as a lazily evaluated range
 	 * @return A lazily evaluated range, of which each element will be the result of invoking a callback.
@@ -159,8 +355,8 @@ public:
 	}
 
 private:
-	auto disconnect(typename container_type::const_pointer callback_pointer) -> void {
-		callbacks.erase(callbacks.get_iterator(callback_pointer));
+	static auto disconnect(void* owner, uint32_t index, uint32_t generation) -> void {
+		static_cast<signal_handler*>(owner)->callbacks.erase(detail::slot_key{index, generation});
 	}
 
 	container_type callbacks;
@@ -0,0 +1,501 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/epoch_readers.hpp>
+#include <events/detail/publish_arg.hpp>
+
+
+// NOLINTBEGIN(cppcoreguidelines-prefer-member-initializer,hicpp-noexcept-move,performance-noexcept-move-constructor)
+
+namespace events {
+
+template<
+	typename FunctionT,
+	typename AllocatorT = std::allocator<void>,
+	typename CallbackT = std::function<FunctionT>
+>
+class snapshot_signal_handler;
+
+
+/**
+ * @brief A thread-safe variant of @ref signal_handler whose publishers never take a lock
+ *
+ * @details The callbacks are held in an immutable snapshot. Publishing reads the current snapshot, while connecting
+ *          or disconnecting a callback builds a new snapshot and replaces the current one under a writer lock. A
+ *          replaced snapshot is reclaimed once no publisher can still be reading it, which is tracked with
+ *          @ref detail::epoch_readers. Publishing only touches a per-thread reader counter, so it scales with the
+ *          number of publishing threads. In exchange, every connect and disconnect copies the list of callbacks, so
+ *          this handler suits callbacks that rarely change. @ref synchronized_signal_handler is cheaper to modify.
+ *
+ *          A publish invokes the callbacks of the snapshot it started with. A callback which is connected during a
+ *          publish is first invoked by the next publish, and a callback which is disconnected may still be invoked by
+ *          publishes which were already in progress. Callbacks may connect and disconnect callbacks of the handler
+ *          that invoked them.
+ *
+ * @tparam CallbackT  The wrapper each callback is stored in. See @ref signal_handler.
+ */
+template<typename ReturnT, typename... ArgsT, typename AllocatorT, typename CallbackT>
+class [[nodiscard]] snapshot_signal_handler<ReturnT(ArgsT...), AllocatorT, CallbackT> {
+public:
+	using function_type = ReturnT(ArgsT...);
+	using allocator_type = AllocatorT;
+	using callback_type = CallbackT;
+
+private:
+	using alloc_traits = std::allocator_traits<AllocatorT>;
+
+	using handle_type = uint64_t;
+
+	struct entry {
+		template<typename FunctionT>
+		entry(handle_type entry_handle, FunctionT&& function) :
+			handle(entry_handle),
+			callback(std::forward<FunctionT>(function)) {
+		}
+
+		handle_type handle;
+		detail::publish_callback_t<CallbackT> callback;
+	};
+
+	// Entries are shared between snapshots, so only the pointers are copied when a snapshot is rebuilt
+	using entry_pointer = std::shared_ptr<entry>;
+	using snapshot_allocator_type = typename alloc_traits::template rebind_alloc<entry_pointer>;
+	using snapshot_type = std::vector<entry_pointer, snapshot_allocator_type>;
+	using snapshot_pointer = std::shared_ptr<snapshot_type const>;
+
+	struct retired_snapshot {
+		snapshot_pointer snapshot;
+		unsigned idle_phases = 0;
+	};
+
+	using retired_allocator_type = typename alloc_traits::template rebind_alloc<retired_snapshot>;
+	using retired_container_type = std::vector<retired_snapshot, retired_allocator_type>;
+
+public:
+	snapshot_signal_handler() : snapshot_signal_handler(AllocatorT{}) {
+	}
+
+	explicit snapshot_signal_handler(AllocatorT const& alloc) :
+		allocator(alloc),
+		live(make_snapshot(snapshot_type(alloc))),
+		current(live.get()),
+		retired(alloc) {
+	}
+
+	/**
+	 * @brief Construct a new snapshot_signal_handler that holds the same callbacks as another.
+	 *
+	 * @details Connection objects from the original signal handler will still only refer to callbacks in that signal
+	 *          handler.
+	 */
+	snapshot_signal_handler(snapshot_signal_handler const& other) :
+		snapshot_signal_handler(other, alloc_traits::select_on_container_copy_construction(other.allocator)) {
+	}
+
+	/**
+	 * @brief Construct a new snapshot_signal_handler that holds the same callbacks as another.
+	 *
+	 * @details Connection objects from the original signal handler will still only refer to callbacks in that signal
+	 *          handler.
+	 */
+	snapshot_signal_handler(snapshot_signal_handler const& other, AllocatorT const& alloc) :
+		snapshot_signal_handler(alloc) {
+		auto lock = std::scoped_lock{other.writer_mut};
+		replace(copy_entries(*other.live));
+	}
+
+	/**
+	 * @brief Construct a new snapshot_signal_handler that will take ownership of another's callbacks
+	 *
+	 * @details Existing connection objects from the original signal handler are invalidated.
+	 */
+	snapshot_signal_handler(snapshot_signal_handler&& other) : snapshot_signal_handler(other.allocator) {
+		take_from(other);
+	}
+
+	/**
+	 * @brief Construct a new snapshot_signal_handler that will take ownership of another's callbacks
+	 *
+	 * @details Existing connection objects from the original signal handler are invalidated.
+	 */
+	snapshot_signal_handler(snapshot_signal_handler&& other, AllocatorT const& alloc) : snapshot_signal_handler(alloc) {
+		take_from(other);
+	}
+
+	// Nothing can be publishing once the handler is destroyed, so the retired snapshots are simply released
+	~snapshot_signal_handler() = default;
+
+	/**
+	 * @brief Copy the callbacks from a snapshot_signal_handler to this one
+	 *
+	 * @details Existing connection objects from this signal handler are invalidated. Connection objects from the other
+	 *          signal handler will still only refer to callbacks in that signal handler.
+	 */
+	auto operator=(snapshot_signal_handler const& other) -> snapshot_signal_handler& {
+		if (&other == this) {
+			return *this;
+		}
+
+		auto locks = std::scoped_lock{writer_mut, other.writer_mut};
+		replace(copy_entries(*other.live));
+
+		return *this;
+	}
+
+	/**
+	 * @brief Move the callbacks from a snapshot_signal_handler to this one
+	 *
+	 * @details Existing connection objects from both signal handlers are invalidated.
+	 */
+	auto operator=(snapshot_signal_handler&& other) -> snapshot_signal_handler& {
+		if (&other == this) {
+			return *this;
+		}
+
+		take_from(other);
+		return *this;
+	}
+
+	[[nodiscard]]
+	constexpr auto get_allocator() const noexcept -> allocator_type {
+		return allocator;
+	}
+
+	/// Get the number of callbacks registered with this signal handler
+	[[nodiscard]]
+	auto size() const noexcept -> size_t {
+		auto lock = std::scoped_lock{writer_mut};
+		return live->size();
+	}
+
+	/**
+	 * @brief Register a callback function that will be invoked when the signal is fired
+	 *
+	 * @param callback  A function that is compatible with the signal handler's function signature
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<std::invocable<ArgsT...> FunctionT>
+	auto connect(FunctionT&& callback) -> connection {
+		auto lock = std::scoped_lock{writer_mut};
+
+		auto const handle = next_handle.fetch_add(1, std::memory_order_relaxed);
+		auto next = snapshot_type(*live, allocator);
+		next.push_back(std::allocate_shared<entry>(allocator, handle, std::forward<FunctionT>(callback)));
+		replace(std::move(next));
+
+		// Handles are never reused, so the 64 bit handle is split across the index and generation of the connection
+		return connection{
+			this, &disconnect, static_cast<uint32_t>(handle), static_cast<uint32_t>(handle >> 32)
+		};
+	}
+
+	/**
+	 * @brief Register a member function that will be invoked on an object when the signal is fired
+	 *
+	 * @details Only the object pointer is stored, and the member function is called directly. The object must
+	 *          outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, ArgsT...>
+	auto connect(ObjectT* instance) -> connection {
+		return connect(detail::member_delegate<Candidate, ObjectT>{instance});
+	}
+
+	/**
+	 * @brief Register a free function that will be invoked when the signal is fired
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), ArgsT...>
+	auto connect() -> connection {
+		return connect(detail::function_delegate<Candidate>{});
+	}
+
+	/// Disconnect all callbacks
+	auto disconnect_all() -> void {
+		auto lock = std::scoped_lock{writer_mut};
+		replace(snapshot_type(allocator));
+	}
+
+	/**
+	 * @brief Fire the signal
+	 *
+	 * @param args The signal arguments
+	 */
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> void requires std::same_as<void, ReturnT>
+	{
+		auto guard = read_guard{readers};
+
+		for (auto const& e : read_snapshot()) {
+			e->callback(args...);
+		}
+	}
+
+	/**
+	 * @brief Fire the signal once for each set of arguments in a batch
+	 *
+	 * @details Callbacks are invoked callback-major: each callback is invoked with every set of arguments before the
+	 *          next callback is invoked. This keeps a single callback's code and data hot for the whole batch, but
+	 *          interleaves callbacks differently than calling @ref publish for each set. The whole batch is published
+	 *          to the same snapshot of callbacks.
+	 *
+	 * @param batch  The argument sets to publish
+	 */
+	auto publish_batch(std::span<std::tuple<ArgsT...> const> batch) -> void requires std::same_as<void, ReturnT>
+	{
+		auto guard = read_guard{readers};
+
+		for (auto const& e : read_snapshot()) {
+			for (auto const& args : batch) {
+				std::apply(e->callback, args);
+			}
+		}
+	}
+
+	/**
+	 * @brief Fire the signal
+	 *
+	 * @param args The signal arguments
+	 *
+	 * @return The callback results
+	 */
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> std::vector<ReturnT> requires(!std::same_as<void, ReturnT>)
+	{
+		auto guard = read_guard{readers};
+		auto const& snapshot = read_snapshot();
+
+		auto results = std::vector<ReturnT>{};
+		results.reserve(snapshot.size());
+
+		for (auto const& e : snapshot) {
+			results.emplace_back(e->callback(args...));
+		}
+
+		return results;
+	}
+
+	/**
+	 * @brief Fire the signal, writing the callback results into a caller-provided buffer
+	 *
+	 * @details Every callback is invoked, but only as many results as fit in the buffer are written. The rest are
+	 *          discarded, which can be detected by comparing the size of the returned span to @ref size.
+	 *
+	 * @param out   The buffer to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return The part of the buffer that was written to
+	 */
+	auto publish_into(std::span<ReturnT> out, detail::publish_arg_t<ArgsT>... args) -> std::span<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto guard = read_guard{readers};
+		auto it = out.begin();
+
+		for (auto const& e : read_snapshot()) {
+			if (it != out.end()) {
+				*it++ = e->callback(args...);
+			}
+			else {
+				e->callback(args...);
+			}
+		}
+
+		return out.first(static_cast<size_t>(it - out.begin()));
+	}
+
+	/**
+	 * @brief Fire the signal, writing the callback results to an output iterator
+	 *
+	 * @param out   The output iterator to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return An iterator past the last result written
+	 */
+	template<std::output_iterator<ReturnT> OutputIt>
+	auto publish_into(OutputIt out, detail::publish_arg_t<ArgsT>... args) -> OutputIt
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto guard = read_guard{readers};
+
+		for (auto const& e : read_snapshot()) {
+			*out++ = e->callback(args...);
+		}
+
+		return out;
+	}
+
+	/**
+	 * @brief Fire the signal, folding the callback results into a single value as they are produced
+	 *
+	 * @details Equivalent to std::accumulate over the results of @ref publish, without collecting them first. Each
+	 *          callback result is combined with the accumulated value as op(std::move(value), result).
+	 *
+	 * @param init  The initial value
+	 * @param op    A binary operation that combines the accumulated value with a callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The accumulated value, or init if no callbacks are connected
+	 */
+	template<typename T, typename BinaryOpT>
+	requires std::convertible_to<std::invoke_result_t<BinaryOpT&, T, ReturnT>, T>
+	auto publish_reduce(T init, BinaryOpT op, detail::publish_arg_t<ArgsT>... args) -> T
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto guard = read_guard{readers};
+
+		for (auto const& e : read_snapshot()) {
+			init = op(std::move(init), e->callback(args...));
+		}
+
+		return init;
+	}
+
+	/**
+	 * @brief Fire the signal, stopping at the first callback whose result satisfies a predicate. Callbacks after that
+	 *        one are not invoked.
+	 *
+	 * @param pred  A predicate that is tested against each callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The first result that satisfied the predicate, or std::nullopt if no result did
+	 */
+	template<std::predicate<ReturnT const&> PredicateT>
+	auto publish_until(PredicateT pred, detail::publish_arg_t<ArgsT>... args) -> std::optional<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto guard = read_guard{readers};
+
+		for (auto const& e : read_snapshot()) {
+			auto result = e->callback(args...);
+
+			if (std::invoke(pred, std::as_const(result))) {
+				return result;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+private:
+	using read_guard = detail::epoch_readers::read_guard;
+
+	// Handles are unique across all handlers of this type, so that entries can be shared when callbacks are moved from
+	// one handler to another without their handles colliding with existing connections
+	static inline auto next_handle = std::atomic<handle_type>{0};
+
+	static auto disconnect(void* owner, uint32_t index, uint32_t generation) -> void {
+		auto* const self = static_cast<snapshot_signal_handler*>(owner);
+		auto const handle = (static_cast<handle_type>(generation) << 32) | index;
+
+		auto lock = std::scoped_lock{self->writer_mut};
+
+		// The handle won't exist if the callback was already disconnected, e.g. through a copy of the connection
+		auto const& snapshot = *self->live;
+		auto const it = std::ranges::find(snapshot, handle, [](entry_pointer const& e) { return e->handle; });
+		if (it == snapshot.end()) {
+			return;
+		}
+
+		auto next = snapshot_type(self->allocator);
+		next.reserve(snapshot.size() - 1);
+		next.insert(next.end(), snapshot.begin(), it);
+		next.insert(next.end(), std::next(it), snapshot.end());
+		self->replace(std::move(next));
+	}
+
+	// Must be called with a read_guard held, which keeps the snapshot alive until the guard is destroyed
+	[[nodiscard]]
+	auto read_snapshot() const noexcept -> snapshot_type const& {
+		return *current.load(std::memory_order_seq_cst);
+	}
+
+	[[nodiscard]]
+	auto make_snapshot(snapshot_type&& snapshot) const -> snapshot_pointer {
+		return std::allocate_shared<snapshot_type>(allocator, std::move(snapshot));
+	}
+
+	// Share the entries of a snapshot, which is cheap, but not the callbacks themselves, which belong to one handler
+	[[nodiscard]]
+	auto copy_entries(snapshot_type const& snapshot) -> snapshot_type {
+		auto result = snapshot_type(allocator);
+		result.reserve(snapshot.size());
+
+		for (auto const& e : snapshot) {
+			auto const handle = next_handle.fetch_add(1, std::memory_order_relaxed);
+			result.push_back(std::allocate_shared<entry>(allocator, handle, e->callback));
+		}
+
+		return result;
+	}
+
+	// Move another handler's entries into this one. Publishes still in progress on the other handler may be using the
+	// entries, so they're shared rather than moved from.
+	auto take_from(snapshot_signal_handler& other) -> void {
+		auto locks = std::scoped_lock{writer_mut, other.writer_mut};
+
+		replace(snapshot_type(*other.live, allocator));
+		other.replace(snapshot_type(other.allocator));
+	}
+
+	// Publish a new snapshot and retire the old one, then reclaim retired snapshots which can no longer be read.
+	// Requires writer_mut.
+	auto replace(snapshot_type&& snapshot) -> void {
+		retired.push_back(retired_snapshot{std::exchange(live, make_snapshot(std::move(snapshot)))});
+		current.store(live.get(), std::memory_order_seq_cst);
+
+		auto const idle = readers.idle_phases();
+
+		for (auto& r : retired) {
+			r.idle_phases |= idle;
+		}
+
+		std::erase_if(retired, [](retired_snapshot const& r) {
+			return r.idle_phases == detail::epoch_readers::all_phases;
+		});
+	}
+
+	AllocatorT allocator;
+
+	// The current snapshot, owned by the writer side
+	snapshot_pointer live;
+
+	// The current snapshot as seen by publishers
+	std::atomic<snapshot_type const*> current;
+
+	// Replaced snapshots which publishers may still be reading
+	retired_container_type retired;
+
+	mutable std::mutex writer_mut;
+
+	detail::epoch_readers readers;
+};
+
+}  //namespace events
+
+// NOLINTEND(cppcoreguidelines-prefer-member-initializer,hicpp-noexcept-move,performance-noexcept-move-constructor)
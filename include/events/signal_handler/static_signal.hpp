@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <events/detail/publish_arg.hpp>
+
+
+namespace events {
+
+template<typename FunctionT, auto... Callables>
+class static_signal;
+
+
+/**
+ * @brief A signal whose listeners are fixed at compile time. Publishing expands into a direct call to each listener,
+ *        in order, with no type erasure, no container, and no locking, so the listeners can be inlined.
+ *
+ * @details Listeners are given as non-type template parameters, e.g. function pointers or captureless lambdas:
+ *          @code
+ *          using on_frame = events::static_signal<void(frame const&), &update_physics, &update_audio>;
+ *          on_frame::publish(current_frame);
+ *          @endcode
+ *          The publish functions mirror those of @ref signal_handler, except that a non-void publish returns the
+ *          results in a std::array, since the number of listeners is known. There is no way to connect or disconnect
+ *          listeners.
+ *
+ * @tparam Callables  The listeners, each invocable with the signal arguments
+ */
+template<typename ReturnT, typename... ArgsT, auto... Callables>
+class [[nodiscard]] static_signal<ReturnT(ArgsT...), Callables...> {
+	static_assert(
+		(std::is_invocable_r_v<ReturnT, decltype(Callables) const&, detail::publish_arg_t<ArgsT>...> && ...),
+		"Every listener must be invocable with the signal arguments"
+	);
+
+	template<auto Callable>
+	static auto invoke(detail::publish_arg_t<ArgsT>... args) -> ReturnT {
+		if constexpr (std::is_void_v<ReturnT>) {
+			std::invoke(Callable, args...);
+		}
+		else {
+			return std::invoke(Callable, args...);
+		}
+	}
+
+	// One entry per listener, so that results can be produced on demand by index
+	static constexpr auto thunks = std::array<ReturnT (*)(detail::publish_arg_t<ArgsT>...), sizeof...(Callables)>{
+		&invoke<Callables>...
+	};
+
+public:
+	using function_type = ReturnT(ArgsT...);
+
+	/// Get the number of listeners
+	[[nodiscard]]
+	static constexpr auto size() noexcept -> size_t {
+		return sizeof...(Callables);
+	}
+
+	/**
+	 * @brief Fire the signal
+	 *
+	 * @param args The signal arguments
+	 */
+	static auto publish(detail::publish_arg_t<ArgsT>... args) -> void requires std::same_as<void, ReturnT>
+	{
+		(invoke<Callables>(args...), ...);
+	}
+
+	/**
+	 * @brief Fire the signal
+	 *
+	 * @param args The signal arguments
+	 *
+	 * @return The listener results, in listener order
+	 */
+	static auto publish(detail::publish_arg_t<ArgsT>... args) -> std::array<ReturnT, sizeof...(Callables)>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		return {invoke<Callables>(args...)...};
+	}
+
+	/**
+	 * @brief Fire the signal, folding the listener results into a single value as they are produced
+	 *
+	 * @param init  The initial value
+	 * @param op    A binary operation that combines the accumulated value with a listener result
+	 * @param args  The signal arguments
+	 *
+	 * @return The accumulated value, or init if there are no listeners
+	 */
+	template<typename T, typename BinaryOpT>
+	requires std::convertible_to<std::invoke_result_t<BinaryOpT&, T, ReturnT>, T>
+	static auto publish_reduce(T init, [[maybe_unused]] BinaryOpT op, detail::publish_arg_t<ArgsT>... args) -> T
+	requires(!std::same_as<void, ReturnT>)
+	{
+		((init = op(std::move(init), invoke<Callables>(args...))), ...);
+		return init;
+	}
+
+	/**
+	 * @brief Fire the signal, stopping at the first listener whose result satisfies a predicate. Listeners after that
+	 *        one are not invoked.
+	 *
+	 * @param pred  A predicate that is tested against each listener result
+	 * @param args  The signal arguments
+	 *
+	 * @return The first result that satisfied the predicate, or std::nullopt if no result did
+	 */
+	template<std::predicate<ReturnT const&> PredicateT>
+	static auto publish_until(PredicateT pred, detail::publish_arg_t<ArgsT>... args) -> std::optional<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto found = std::optional<ReturnT>{};
+
+		auto test = [&]<auto Callable>() {
+			auto result = invoke<Callable>(args...);
+
+			if (std::invoke(pred, std::as_const(result))) {
+				found.emplace(std::move(result));
+				return true;
+			}
+			return false;
+		};
+
+		(test.template operator()<Callables>() || ...);
+
+		return found;
+	}
+
+	/**
+	 * @brief Fire the signal, writing the listener results into a caller-provided buffer
+	 *
+	 * @details Every listener is invoked, but only as many results as fit in the buffer are written. The rest are
+	 *          discarded, which can be detected by comparing the size of the returned span to @ref size.
+	 *
+	 * @param out   The buffer to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return The part of the buffer that was written to
+	 */
+	static auto publish_into(std::span<ReturnT> out, detail::publish_arg_t<ArgsT>... args) -> std::span<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		auto written = size_t{0};
+
+		[[maybe_unused]] auto write = [&](ReturnT&& result) {
+			if (written < out.size()) {
+				out[written++] = std::move(result);
+			}
+		};
+
+		(write(invoke<Callables>(args...)), ...);
+
+		return out.first(written);
+	}
+
+	/**
+	 * @brief Fire the signal, writing the listener results to an output iterator
+	 *
+	 * @param out   The output iterator to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return An iterator past the last result written
+	 */
+	template<std::output_iterator<ReturnT> OutputIt>
+	static auto publish_into(OutputIt out, detail::publish_arg_t<ArgsT>... args) -> OutputIt
+	requires(!std::same_as<void, ReturnT>)
+	{
+		((*out++ = invoke<Callables>(args...)), ...);
+		return out;
+	}
+
+	/**
+	 * @brief Fire the signal as a lazily evaluated range
+	 * @return A lazily evaluated range, of which each element will be the result of invoking a listener.
+	 */
+	static auto publish_range(ArgsT... args) requires(!std::same_as<void, ReturnT>)
+	{
+		return std::views::iota(size_t{0}, size())
+		    | std::views::transform([... args = std::forward<ArgsT>(args)](size_t index) mutable -> ReturnT {
+			       return thunks[index](args...);
+		       });
+	}
+};
+
+}  //namespace events
@@ -2,9 +2,14 @@
 
 #include <atomic>
 #include <concepts>
+#include <cstdint>
 #include <functional>
 #include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <span>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -12,29 +17,39 @@
 #include <plf_colony.h>
 
 #include <events/connection.hpp>
+#include <events/detail/delegate.hpp>
+#include <events/detail/publish_arg.hpp>
+#include <events/small_function.hpp>
 
 
 // NOLINTBEGIN(cppcoreguidelines-prefer-member-initializer,hicpp-noexcept-move,performance-noexcept-move-constructor)
 
 namespace events {
 
-template<typename FunctionT, typename AllocatorT = std::allocator<void>>
+template<
+	typename FunctionT,
+	typename AllocatorT = std::allocator<void>,
+	typename CallbackT = std::function<FunctionT>
+>
 class synchronized_signal_handler;
 
 
 /**
  * @brief A thread-safe variant of @ref signal_handler
+ *
+ * @tparam CallbackT  The wrapper each callback is stored in. See @ref signal_handler.
  */
-template<typename ReturnT, typename... ArgsT, typename AllocatorT>
-class [[nodiscard]] synchronized_signal_handler<ReturnT(ArgsT...), AllocatorT> {
+template<typename ReturnT, typename... ArgsT, typename AllocatorT, typename CallbackT>
+class [[nodiscard]] synchronized_signal_handler<ReturnT(ArgsT...), AllocatorT, CallbackT> {
 public:
 	using function_type = ReturnT(ArgsT...);
 	using allocator_type = AllocatorT;
+	using callback_type = CallbackT;
 
 private:
 	using alloc_traits = std::allocator_traits<AllocatorT>;
 
-	using element_type = std::function<function_type>;
+	using element_type = detail::publish_callback_t<CallbackT>;
 	using container_allocator_type = typename alloc_traits::template rebind_alloc<element_type>;
 	using container_type = plf::colony<element_type, container_allocator_type>;
 
@@ -94,11 +109,14 @@ public:
 	synchronized_signal_handler(synchronized_signal_handler&& other) {
 		auto locks = std::scoped_lock{other.callback_mut, other.handle_mut, other.add_mut, other.erase_mut};
 
+		// Connections can only refer to the handler that created them, so the other handler's handles aren't needed
+		// once its pending operations have been applied.
+		other.erase_expired_callbacks_impl();
+		other.add_pending_callbacks_impl();
+
 		callbacks = std::move(other.callbacks);
-		handles = std::move(other.handles);
-		to_add = std::move(other.to_add);
-		to_erase = std::move(other.to_erase);
-		next_handle = other.next_handle;
+		other.handles.clear();
+		next_handle = other.next_handle.load();
 	}
 
 	/**
@@ -106,14 +124,18 @@ public:
 	 *
 	 * @details Existing connection objects from the original signal handler are invalidated.
 	 */
-	synchronized_signal_handler(synchronized_signal_handler&& other, AllocatorT const& alloc) {
+	synchronized_signal_handler(synchronized_signal_handler&& other, AllocatorT const& alloc) :
+		handles(alloc),
+		to_add(alloc),
+		to_erase(alloc) {
 		auto locks = std::scoped_lock{other.callback_mut, other.handle_mut, other.add_mut, other.erase_mut};
 
+		other.erase_expired_callbacks_impl();
+		other.add_pending_callbacks_impl();
+
 		callbacks = container_type{std::move(other.callbacks), alloc};
-		handles = handle_container_type{std::move(other.handles), alloc};
-		to_add = add_container_type{std::move(other.to_add), alloc};
-		to_erase = erase_container_type{std::move(other.to_erase), alloc};
-		next_handle = other.next_handle;
+		other.handles.clear();
+		next_handle = other.next_handle.load();
 	}
 
 	~synchronized_signal_handler() = default;
@@ -157,11 +179,16 @@ public:
 			other.callback_mut, other.handle_mut, other.add_mut, other.erase_mut
 		};
 
+		other.erase_expired_callbacks_impl();
+		other.add_pending_callbacks_impl();
+
 		callbacks = std::move(other.callbacks);
-		handles = std::move(other.handles);
-		to_add = std::move(other.to_add);
-		to_erase = std::move(other.to_erase);
-		next_handle = other.next_handle;
+		other.handles.clear();
+
+		// Handles keep counting up from this handler's last handle, so existing connections won't match new ones
+		handles.clear();
+		to_add.clear();
+		to_erase.clear();
 
 		return *this;
 	}
@@ -174,7 +201,7 @@ public:
 	/// Get the number of callbacks registered with this signal handler
 	[[nodiscard]]
 	auto size() const noexcept -> size_t {
-		auto lock = std::scoped_lock{callback_mut};
+		auto lock = std::shared_lock{callback_mut};
 		return callbacks.size();
 	}
 
@@ -189,33 +216,70 @@ public:
 	template<std::invocable<ArgsT...> FunctionT>
 	auto connect(FunctionT&& callback) -> connection {
 		auto const handle = next_handle.fetch_add(1);
-		auto callback_ptr = typename container_type::const_pointer{nullptr};
 
-		{
-			auto callback_lock = std::unique_lock{callback_mut, std::try_to_lock};
+		if (auto callback_lock = std::unique_lock{callback_mut, std::try_to_lock}) {
+			auto const callback_ptr = &(*callbacks.insert(std::forward<FunctionT>(callback)));
+			callback_lock.unlock();
 
-			if (callback_lock) {
-				auto const it = callbacks.insert(std::forward<FunctionT>(callback));
-				callback_ptr = &(*it);
-			}
-			else {
-				auto add_lock = std::scoped_lock{add_mut};
-				to_add.emplace_back(handle, std::forward<FunctionT>(callback));
-			}
-		}
-
-		{
 			auto handle_lock = std::scoped_lock{handle_mut};
 			handles[handle] = callback_ptr;
 		}
+		else {
+			// The handle must be registered before the callback is enqueued. Otherwise a concurrent publish could
+			// add the pending callbacks in between, find no handle, and drop this callback as disconnected.
+			{
+				auto handle_lock = std::scoped_lock{handle_mut};
+				handles[handle] = nullptr;
+			}
+
+			auto add_lock = std::scoped_lock{add_mut};
+			to_add.emplace_back(handle, std::forward<FunctionT>(callback));
+		}
+
+		// Handles are never reused, so the 64 bit handle is split across the index and generation of the connection
+		return connection{
+			this, &disconnect, static_cast<uint32_t>(handle), static_cast<uint32_t>(handle >> 32)
+		};
+	}
+
+	/**
+	 * @brief Register a member function that will be invoked on an object when the signal is fired
+	 *
+	 * @details The callback holds nothing but the object pointer, so it fits in the inline buffer of std::function
+	 *          or @ref small_function and connecting doesn't allocate. It is still invoked through the callback
+	 *          wrapper, like any other callback. The object must outlive the connection.
+	 *
+	 * @tparam Candidate  A pointer to the member function to invoke
+	 *
+	 * @param instance  The object to invoke the member function on
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate, typename ObjectT>
+	requires std::invocable<decltype(Candidate), ObjectT*, ArgsT...>
+	auto connect(ObjectT* instance) -> connection {
+		return connect(detail::member_delegate<Candidate, ObjectT>{instance});
+	}
 
-		return connection{[this, handle] { disconnect(handle); }};
+	/**
+	 * @brief Register a free function that will be invoked when the signal is fired
+	 *
+	 * @tparam Candidate  A pointer to the function to invoke
+	 *
+	 * @return A connection handle that can be used to disconnect the function from this signal handler
+	 */
+	template<auto Candidate>
+	requires std::invocable<decltype(Candidate), ArgsT...>
+	auto connect() -> connection {
+		return connect(detail::function_delegate<Candidate>{});
 	}
 
 	/// Disconnect all callbacks
 	auto disconnect_all() -> void {
-		auto lock = std::scoped_lock{callback_mut};
+		auto lock = std::scoped_lock{callback_mut, handle_mut, add_mut, erase_mut};
 		callbacks.clear();
+		handles.clear();
+		to_add.clear();
 		to_erase.clear();
 	}
 
@@ -224,7 +288,7 @@ public:
 	 *
 	 * @param args The signal arguments
 	 */
-	auto publish(ArgsT... args) -> void requires std::same_as<void, ReturnT>
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> void requires std::same_as<void, ReturnT>
 	{
 		erase_expired_callbacks();
 
@@ -239,6 +303,33 @@ public:
 		add_pending_callbacks();
 	}
 
+	/**
+	 * @brief Fire the signal once for each set of arguments in a batch
+	 *
+	 * @details Callbacks are invoked callback-major: each callback is invoked with every set of arguments before the
+	 *          next callback is invoked. This keeps a single callback's code and data hot for the whole batch, but
+	 *          interleaves callbacks differently than calling @ref publish for each set. The
+	 *          callback lock is only acquired once for the whole batch.
+	 *
+	 * @param batch  The argument sets to publish
+	 */
+	auto publish_batch(std::span<std::tuple<ArgsT...> const> batch) -> void requires std::same_as<void, ReturnT>
+	{
+		erase_expired_callbacks();
+
+		{
+			auto lock = std::shared_lock{callback_mut};
+
+			for (auto& callback : callbacks) {
+				for (auto const& args : batch) {
+					std::apply(callback, args);
+				}
+			}
+		}
+
+		add_pending_callbacks();
+	}
+
 	/**
 	 * @brief Fire the signal
 	 *
@@ -246,7 +337,7 @@ public:
 	 *
 	 * @return The callback results
 	 */
-	auto publish(ArgsT... args) -> std::vector<ReturnT> requires(!std::same_as<void, ReturnT>)
+	auto publish(detail::publish_arg_t<ArgsT>... args) -> std::vector<ReturnT> requires(!std::same_as<void, ReturnT>)
 	{
 		erase_expired_callbacks();
 
@@ -266,10 +357,143 @@ public:
 		return results;
 	}
 
+	/**
+	 * @brief Fire the signal, writing the callback results into a caller-provided buffer
+	 *
+	 * @details Every callback is invoked, but only as many results as fit in the buffer are written. The rest are
+	 *          discarded, which can be detected by comparing the size of the returned span to @ref size.
+	 *
+	 * @param out   The buffer to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return The part of the buffer that was written to
+	 */
+	auto publish_into(std::span<ReturnT> out, detail::publish_arg_t<ArgsT>... args) -> std::span<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		erase_expired_callbacks();
+
+		auto it = out.begin();
+
+		{
+			auto lock = std::shared_lock{callback_mut};
+
+			for (auto& callback : callbacks) {
+				if (it != out.end()) {
+					*it++ = callback(args...);
+				}
+				else {
+					callback(args...);
+				}
+			}
+		}
+
+		add_pending_callbacks();
+
+		return out.first(static_cast<size_t>(it - out.begin()));
+	}
+
+	/**
+	 * @brief Fire the signal, writing the callback results to an output iterator
+	 *
+	 * @param out   The output iterator to write results to
+	 * @param args  The signal arguments
+	 *
+	 * @return An iterator past the last result written
+	 */
+	template<std::output_iterator<ReturnT> OutputIt>
+	auto publish_into(OutputIt out, detail::publish_arg_t<ArgsT>... args) -> OutputIt
+	requires(!std::same_as<void, ReturnT>)
+	{
+		erase_expired_callbacks();
+
+		{
+			auto lock = std::shared_lock{callback_mut};
+
+			for (auto& callback : callbacks) {
+				*out++ = callback(args...);
+			}
+		}
+
+		add_pending_callbacks();
+
+		return out;
+	}
+
+	/**
+	 * @brief Fire the signal, folding the callback results into a single value as they are produced
+	 *
+	 * @details Equivalent to std::accumulate over the results of @ref publish, without collecting them first. Each
+	 *          callback result is combined with the accumulated value as op(std::move(value), result).
+	 *
+	 * @param init  The initial value
+	 * @param op    A binary operation that combines the accumulated value with a callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The accumulated value, or init if no callbacks are connected
+	 */
+	template<typename T, typename BinaryOpT>
+	requires std::convertible_to<std::invoke_result_t<BinaryOpT&, T, ReturnT>, T>
+	auto publish_reduce(T init, BinaryOpT op, detail::publish_arg_t<ArgsT>... args) -> T
+	requires(!std::same_as<void, ReturnT>)
+	{
+		erase_expired_callbacks();
+
+		{
+			auto lock = std::shared_lock{callback_mut};
+
+			for (auto& callback : callbacks) {
+				init = op(std::move(init), callback(args...));
+			}
+		}
+
+		add_pending_callbacks();
+
+		return init;
+	}
+
+	/**
+	 * @brief Fire the signal, stopping at the first callback whose result satisfies a predicate. Callbacks after that
+	 *        one are not invoked.
+	 *
+	 * @param pred  A predicate that is tested against each callback result
+	 * @param args  The signal arguments
+	 *
+	 * @return The first result that satisfied the predicate, or std::nullopt if no result did
+	 */
+	template<std::predicate<ReturnT const&> PredicateT>
+	auto publish_until(PredicateT pred, detail::publish_arg_t<ArgsT>... args) -> std::optional<ReturnT>
+	requires(!std::same_as<void, ReturnT>)
+	{
+		erase_expired_callbacks();
+
+		auto found = std::optional<ReturnT>{};
+
+		{
+			auto lock = std::shared_lock{callback_mut};
+
+			for (auto& callback : callbacks) {
+				auto result = callback(args...);
+
+				if (std::invoke(pred, std::as_const(result))) {
+					found.emplace(std::move(result));
+					break;
+				}
+			}
+		}
+
+		add_pending_callbacks();
+
+		return found;
+	}
+
 private:
-	auto disconnect(handle_type handle) -> void {
-		auto lock = std::scoped_lock{erase_mut};
-		to_erase.push_back(handle);
+	static auto disconnect(void* owner, uint32_t index, uint32_t generation) -> void {
+		auto* const self = static_cast<synchronized_signal_handler*>(owner);
+		auto const handle = (static_cast<handle_type>(generation) << 32) | index;
+
+		auto lock = std::scoped_lock{self->erase_mut};
+		self->to_erase.push_back(handle);
 	}
 
 	auto add_pending_callbacks() -> void {
@@ -288,7 +512,7 @@ private:
 
 			// If the handle doesn't exist in the handle map, then this callback was disconnected before it could be
 			// inserted into the callback list. In this case, just skip it.
-			if (it != handles.end()) {
+			if (it == handles.end()) {
 				continue;
 			}
 
@@ -314,6 +538,11 @@ private:
 		for (auto handle : to_erase) {
 			auto const it = handles.find(handle);
 
+			// The handle won't exist if the callback was already disconnected, e.g. through a copy of the connection
+			if (it == handles.end()) {
+				continue;
+			}
+
 			// The pointer will be null if the callback is still pending insertion. Nothing special needs to be done
 			// in this case other than skipping the actual callback deletion. This case will be detected and the
 			// pending callback will be deleted when attempting to add the enqueued callbacks.
@@ -328,7 +557,7 @@ private:
 	}
 
 	container_type callbacks;
-	std::shared_mutex callback_mut;
+	mutable std::shared_mutex callback_mut;
 
 	handle_container_type handles;
 	std::atomic<handle_type> next_handle = 0;
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace events {
+
+/// The default inline buffer size of a @ref small_function. Large enough for a lambda capturing a few pointers.
+inline constexpr size_t default_small_function_size = 4 * sizeof(void*);
+
+
+template<typename FunctionT, size_t BufferSize = default_small_function_size>
+class small_function;
+
+
+/**
+ * @brief A move-only callable wrapper with an inline buffer. Callables which fit in the buffer and are nothrow move
+ *        constructible are stored inline, so constructing the wrapper won't allocate. Larger callables fall back to a
+ *        heap allocation.
+ *
+ * @details Invoking a small_function is a single indirect call. Like std::function, invoking an empty small_function
+ *          throws std::bad_function_call.
+ *
+ * @tparam BufferSize  The size of the inline buffer, in bytes
+ */
+template<typename ReturnT, typename... ArgsT, size_t BufferSize>
+class small_function<ReturnT(ArgsT...), BufferSize> {
+	static_assert(BufferSize >= sizeof(void*), "The buffer must be able to hold at least a pointer");
+
+	enum class operation { move, destroy };
+
+	using invoke_type = ReturnT (*)(void*, ArgsT&&...);
+	using manage_type = void (*)(operation, void*, void*) noexcept;
+
+	template<typename FunctionT>
+	static constexpr bool stored_inline = sizeof(FunctionT) <= BufferSize
+	                                   && alignof(FunctionT) <= alignof(std::max_align_t)
+	                                   && std::is_nothrow_move_constructible_v<FunctionT>;
+
+public:
+	using result_type = ReturnT;
+
+	/// The size of the inline buffer, in bytes
+	static constexpr size_t buffer_size = BufferSize;
+
+	small_function() noexcept = default;
+
+	small_function(std::nullptr_t) noexcept {  //NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+	}
+
+	template<typename FunctionT>
+	requires(!std::same_as<std::remove_cvref_t<FunctionT>, small_function>)
+	     && std::is_invocable_r_v<ReturnT, std::decay_t<FunctionT>&, ArgsT...>
+	small_function(FunctionT&& func) {  //NOLINT(google-explicit-constructor,hicpp-explicit-conversions)
+		using function_type = std::decay_t<FunctionT>;
+
+		if constexpr (std::is_pointer_v<function_type> || std::is_member_pointer_v<function_type>) {
+			if (func == nullptr) {
+				return;
+			}
+		}
+
+		if constexpr (stored_inline<function_type>) {
+			::new (static_cast<void*>(&buffer)) function_type(std::forward<FunctionT>(func));
+		}
+		else {
+			::new (static_cast<void*>(&buffer)) function_type*(new function_type(std::forward<FunctionT>(func)));
+		}
+
+		invoker = &invoke<function_type>;
+		manager = &manage<function_type>;
+	}
+
+	small_function(small_function const&) = delete;
+
+	small_function(small_function&& other) noexcept {
+		move_from(other);
+	}
+
+	~small_function() {
+		reset();
+	}
+
+	auto operator=(small_function const&) -> small_function& = delete;
+
+	auto operator=(small_function&& other) noexcept -> small_function& {
+		if (&other != this) {
+			reset();
+			move_from(other);
+		}
+		return *this;
+	}
+
+	auto operator=(std::nullptr_t) noexcept -> small_function& {
+		reset();
+		return *this;
+	}
+
+	[[nodiscard]] explicit operator bool() const noexcept {
+		return manager != nullptr;
+	}
+
+	auto operator()(ArgsT... args) const -> ReturnT {
+		return invoker(&buffer, std::forward<ArgsT>(args)...);
+	}
+
+private:
+	template<typename FunctionT>
+	[[nodiscard]]
+	static auto target(void* storage) noexcept -> FunctionT* {
+		if constexpr (stored_inline<FunctionT>) {
+			return std::launder(static_cast<FunctionT*>(storage));
+		}
+		else {
+			return *std::launder(static_cast<FunctionT**>(storage));
+		}
+	}
+
+	template<typename FunctionT>
+	static auto invoke(void* storage, ArgsT&&... args) -> ReturnT {
+		if constexpr (std::is_void_v<ReturnT>) {
+			std::invoke(*target<FunctionT>(storage), std::forward<ArgsT>(args)...);
+		}
+		else {
+			return std::invoke(*target<FunctionT>(storage), std::forward<ArgsT>(args)...);
+		}
+	}
+
+	[[noreturn]]
+	static auto invoke_empty(void*, ArgsT&&...) -> ReturnT {
+		throw std::bad_function_call{};
+	}
+
+	template<typename FunctionT>
+	static auto manage(operation op, void* dest, void* src) noexcept -> void {
+		switch (op) {
+			case operation::move:
+				if constexpr (stored_inline<FunctionT>) {
+					::new (dest) FunctionT(std::move(*target<FunctionT>(src)));
+					std::destroy_at(target<FunctionT>(src));
+				}
+				else {
+					::new (dest) FunctionT*(target<FunctionT>(src));
+				}
+				break;
+
+			case operation::destroy:
+				if constexpr (stored_inline<FunctionT>) {
+					std::destroy_at(target<FunctionT>(dest));
+				}
+				else {
+					delete target<FunctionT>(dest);
+				}
+				break;
+		}
+	}
+
+	auto move_from(small_function& other) noexcept -> void {
+		if (other.manager) {
+			other.manager(operation::move, &buffer, &other.buffer);
+			invoker = std::exchange(other.invoker, &invoke_empty);
+			manager = std::exchange(other.manager, nullptr);
+		}
+	}
+
+	auto reset() noexcept -> void {
+		if (manager) {
+			manager(operation::destroy, &buffer, nullptr);
+			invoker = &invoke_empty;
+			manager = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) mutable std::byte buffer[BufferSize];  //NOLINT(*-avoid-c-arrays)
+
+	invoke_type invoker = &invoke_empty;
+	manage_type manager = nullptr;
+};
+
+}  //namespace events
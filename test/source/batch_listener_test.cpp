@@ -0,0 +1,78 @@
+#include <events/dispatcher/event_dispatcher.hpp>
+#include <events/dispatcher/static_event_dispatcher.hpp>
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+struct sample_event {
+	int value = 0;
+};
+
+template<typename DispatcherT>
+auto check_batches(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto batches = std::vector<std::vector<int>>{};
+	auto order = std::string{};
+
+	auto batch_connection = dispatcher.template connect_batch<sample_event>(
+		[&](std::span<sample_event const> events) {
+			auto& batch = batches.emplace_back();
+			for (auto const& event : events) {
+				batch.push_back(event.value);
+			}
+			order += 'b';
+		}
+	);
+	dispatcher.template connect<sample_event>([&](sample_event const&) {
+		order += 'e';
+	});
+
+	for (int i = 0; i < 4; ++i) {
+		dispatcher.enqueue(sample_event{i});
+	}
+	dispatcher.dispatch();
+	check(batches == std::vector<std::vector<int>>{{0, 1, 2, 3}}, "a batch listener receives every event at once");
+	check(order == "beeee", "batch listeners are invoked before per-event listeners");
+
+	// Events that are sent immediately reach batch listeners one at a time
+	batches.clear();
+	dispatcher.send(sample_event{7});
+	check(batches == std::vector<std::vector<int>>{{7}}, "a sent event is a batch of one");
+
+	// A budgeted dispatch hands out as many events as the budget allows, and keeps the rest for the next dispatch
+	batches.clear();
+	for (int i = 0; i < 5; ++i) {
+		dispatcher.enqueue(sample_event{i});
+	}
+	check(dispatcher.dispatch_n(3) == 3, "a batch claims the budget for its events");
+	check(dispatcher.dispatch_n(10) == 2, "the rest of the events are dispatched later");
+	check(batches == std::vector<std::vector<int>>{{0, 1, 2}, {3, 4}}, "a budget splits the events into batches");
+
+	batches.clear();
+	batch_connection.disconnect();
+	dispatcher.enqueue(sample_event{1});
+	dispatcher.dispatch();
+	check(batches.empty(), "a disconnected batch listener receives nothing");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_batches<events::event_dispatcher>("event_dispatcher");
+	check_batches<events::synchronized_event_dispatcher>("synchronized_event_dispatcher");
+	check_batches<events::static_event_dispatcher<sample_event>>("static_event_dispatcher");
+
+	std::cout << "batch listener checks passed\n";
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <events/dispatcher/event_dispatcher.hpp>
+#include <events/dispatcher/static_event_dispatcher.hpp>
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+struct busy_event {
+	int value = 0;
+};
+
+struct quiet_event {
+	int value = 0;
+};
+
+using received_type = std::vector<std::pair<char, int>>;
+
+template<typename DispatcherT>
+auto connect_recording(DispatcherT& dispatcher, received_type& received) -> void {
+	dispatcher.template connect<busy_event>([&received](busy_event const& event) {
+		received.emplace_back('b', event.value);
+	});
+	dispatcher.template connect<quiet_event>([&received](quiet_event const& event) {
+		received.emplace_back('q', event.value);
+	});
+}
+
+template<typename DispatcherT>
+auto check_dispatch_n(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto received = received_type{};
+	connect_recording(dispatcher, received);
+
+	for (int i = 0; i < 6; ++i) {
+		dispatcher.enqueue(busy_event{i});
+	}
+
+	check(dispatcher.dispatch_n(0) == 0, "a zero budget dispatches nothing");
+	check(dispatcher.dispatch_n(4) == 4, "dispatch_n stops at its budget");
+	check(received == received_type{{'b', 0}, {'b', 1}, {'b', 2}, {'b', 3}}, "dispatch_n dispatches in order");
+	check(dispatcher.queue_size() == 2, "undispatched events stay queued");
+
+	// New events are queued after the ones a budgeted dispatch left over
+	dispatcher.enqueue(busy_event{6});
+	received.clear();
+	check(dispatcher.dispatch_n(10) == 3, "dispatch_n returns the number of events dispatched");
+	check(received == received_type{{'b', 4}, {'b', 5}, {'b', 6}}, "leftover events are dispatched first");
+	check(dispatcher.queue_size() == 0, "the budget drained the queue");
+}
+
+// A busy event type mustn't starve the others: each call resumes after the type where the last one ran out
+template<typename DispatcherT>
+auto check_round_robin(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto received = received_type{};
+	connect_recording(dispatcher, received);
+
+	for (int i = 0; i < 100; ++i) {
+		dispatcher.enqueue(busy_event{i});
+	}
+	dispatcher.enqueue(quiet_event{0});
+
+	auto quiet_dispatched = false;
+	for (int call = 0; call < 3 && !quiet_dispatched; ++call) {
+		received.clear();
+		dispatcher.dispatch_n(5);
+		for (auto const& [type, value] : received) {
+			quiet_dispatched = quiet_dispatched || type == 'q';
+		}
+	}
+	check(quiet_dispatched, "a quiet event type is reached while a busy one still has events");
+
+	dispatcher.dispatch();
+	check(dispatcher.queue_size() == 0, "a full dispatch drains every event type");
+}
+
+template<typename DispatcherT>
+auto check_dispatch_for(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto received = received_type{};
+	connect_recording(dispatcher, received);
+
+	for (int i = 0; i < 10; ++i) {
+		dispatcher.enqueue(busy_event{i});
+	}
+
+	check(dispatcher.dispatch_for(std::chrono::nanoseconds{0}) == 0, "an expired budget dispatches nothing");
+	check(dispatcher.dispatch_for(std::chrono::hours{1}) == 10, "a generous budget dispatches everything");
+	check(received.size() == 10 && received.back() == std::pair{'b', 9}, "dispatch_for dispatches in order");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	using static_dispatcher = events::static_event_dispatcher<busy_event, quiet_event>;
+
+	check_dispatch_n<events::event_dispatcher>("event_dispatcher");
+	check_dispatch_n<events::synchronized_event_dispatcher>("synchronized_event_dispatcher");
+	check_dispatch_n<static_dispatcher>("static_event_dispatcher");
+
+	check_round_robin<events::event_dispatcher>("event_dispatcher round robin");
+	check_round_robin<events::synchronized_event_dispatcher>("synchronized_event_dispatcher round robin");
+	check_round_robin<static_dispatcher>("static_event_dispatcher round robin");
+
+	check_dispatch_for<events::event_dispatcher>("event_dispatcher with a time budget");
+	check_dispatch_for<events::synchronized_event_dispatcher>("synchronized_event_dispatcher with a time budget");
+	check_dispatch_for<static_dispatcher>("static_event_dispatcher with a time budget");
+
+	std::cout << "budgeted dispatch checks passed\n";
+	return 0;
+}
@@ -0,0 +1,138 @@
+#include <events/signal_handler/signal_handler.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+// Connect and disconnect callbacks at random, checking after every step that exactly the connected callbacks are
+// invoked by a publish. Each callback records its ID, so a callback that was moved to a different position by the
+// storage must still be the same callback.
+template<typename StorageT>
+auto check_churn(char const* name) -> void {
+	using function_type = void(std::vector<int>&);
+	using handler_type = events::signal_handler<
+		function_type, std::allocator<void>, std::function<function_type>, StorageT
+	>;
+
+	auto handler = handler_type{};
+
+	auto connections = std::map<int, events::connection>{};
+	auto random = std::mt19937{1234};
+	auto next_id = 0;
+
+	for (size_t step = 0; step < 2000; ++step) {
+		// Favor connecting while there are few callbacks, so the number of callbacks moves up and down
+		auto const roll = std::uniform_int_distribution<size_t>{0, 16}(random);
+		auto const connect = connections.empty() || roll > connections.size();
+
+		if (connect) {
+			auto const id = next_id++;
+			connections.emplace(id, handler.connect([id](std::vector<int>& seen) { seen.push_back(id); }));
+		}
+		else {
+			auto it = connections.begin();
+			std::advance(it, std::uniform_int_distribution<size_t>{0, connections.size() - 1}(random));
+			it->second.disconnect();
+			connections.erase(it);
+		}
+
+		auto seen = std::vector<int>{};
+		handler.publish(seen);
+		std::ranges::sort(seen);
+
+		auto expected = std::vector<int>{};
+		for (auto const& [id, connection] : connections) {
+			expected.push_back(id);
+		}
+
+		if (seen != expected) {
+			std::cerr << name << ": mismatch at step " << step << '\n';
+		}
+		check(seen == expected, "exactly the connected callbacks are invoked");
+		check(handler.size() == connections.size(), "the handler counts the connected callbacks");
+	}
+
+	handler.disconnect_all();
+	auto seen = std::vector<int>{};
+	handler.publish(seen);
+	check(seen.empty() && handler.size() == 0, "disconnect_all removes every callback");
+}
+
+// Reserving space up front and returning results works the same for every policy
+template<typename StorageT>
+auto check_results() -> void {
+	auto handler = events::signal_handler<int(int), std::allocator<void>, std::function<int(int)>, StorageT>{};
+	handler.reserve(8);
+
+	auto first = handler.connect([](int n) { return n; });
+	handler.connect([](int n) { return n * 10; });
+	handler.connect([](int n) { return n * 100; });
+
+	first.disconnect();
+
+	auto results = handler.publish(2);
+	std::ranges::sort(results);
+	check(results == std::vector{20, 200}, "the remaining callbacks return their results");
+
+	// A copy holds its own callbacks
+	auto copy = handler;
+	handler.disconnect_all();
+	check(copy.publish(1).size() == 2, "a copied handler keeps its callbacks");
+}
+
+// Inline storage moves its callbacks between the inline buffer and the heap, and between handlers
+auto check_inline_moves() -> void {
+	using storage_type = events::inline_storage<2>;
+	using handler_type = events::signal_handler<int(), std::allocator<void>, std::function<int()>, storage_type>;
+
+	auto small = handler_type{};
+	small.connect([] { return 1; });
+	check(small.publish() == std::vector{1}, "a single inline callback is invoked");
+
+	auto large = handler_type{};
+	for (auto i = 0; i < 5; ++i) {
+		large.connect([i] { return i; });
+	}
+	check(large.publish().size() == 5, "callbacks past the inline capacity are moved to the heap");
+
+	auto moved_small = std::move(small);
+	auto moved_large = std::move(large);
+	check(moved_small.publish() == std::vector{1}, "moving inline callbacks keeps them");
+	check(moved_large.publish().size() == 5, "moving heap callbacks keeps them");
+	check(small.size() == 0 && large.size() == 0, "a moved-from handler is empty");  //NOLINT(bugprone-use-after-move)
+
+	moved_small = moved_large;
+	check(moved_small.publish().size() == 5, "copy assignment replaces the callbacks");
+	check(moved_large.publish().size() == 5, "copy assignment leaves the source unchanged");
+
+	moved_large = std::move(moved_small);
+	moved_large.connect([] { return 6; });
+	check(moved_large.publish().size() == 6, "a handler can connect after move assignment");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_churn<events::colony_storage>("colony_storage");
+	check_churn<events::dense_storage>("dense_storage");
+	check_churn<events::inline_storage<1>>("inline_storage<1>");
+	check_churn<events::inline_storage<4>>("inline_storage<4>");
+
+	check_results<events::colony_storage>();
+	check_results<events::dense_storage>();
+	check_results<events::inline_storage<2>>();
+
+	check_inline_moves();
+
+	std::cout << "callback storage checks passed\n";
+	return 0;
+}
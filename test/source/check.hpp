@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+#include <source_location>
+
+
+/// Report a failed condition and exit. Unlike assert, this is also checked in release builds.
+inline auto check(bool condition, char const* description, std::source_location location = std::source_location::current()) -> void {
+	if (!condition) {
+		std::cerr << location.file_name() << ':' << location.line() << ": check failed: " << description << '\n';
+		std::exit(EXIT_FAILURE);
+	}
+}
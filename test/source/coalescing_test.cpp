@@ -0,0 +1,141 @@
+#include <events/dispatcher/event_dispatcher.hpp>
+#include <events/dispatcher/static_event_dispatcher.hpp>
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+struct position_event {
+	int entity = 0;
+	int x = 0;
+};
+
+using received_type = std::vector<std::pair<int, int>>;
+
+template<typename DispatcherT>
+auto connect_recording(DispatcherT& dispatcher, received_type& received) -> void {
+	dispatcher.template connect<position_event>([&received](position_event const& event) {
+		received.emplace_back(event.entity, event.x);
+	});
+}
+
+template<typename DispatcherT>
+auto check_coalescing(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto received = received_type{};
+	connect_recording(dispatcher, received);
+
+	// The latest event per key is dispatched, at the position of the first one
+	dispatcher.enqueue_coalesced(1, position_event{1, 10});
+	dispatcher.enqueue_coalesced(2, position_event{2, 20});
+	dispatcher.enqueue(position_event{3, 30});
+	dispatcher.enqueue_coalesced(1, position_event{1, 11});
+	dispatcher.enqueue_coalesced(1, position_event{1, 12});
+	check(dispatcher.template queue_size<position_event>() == 3, "coalesced events don't grow the queue");
+
+	dispatcher.dispatch();
+	check(received == received_type{{1, 12}, {2, 20}, {3, 30}}, "a coalesced event replaces the pending one in place");
+
+	// Keys are only matched against pending events, so the same key starts over after a dispatch
+	received.clear();
+	dispatcher.enqueue_coalesced(1, position_event{1, 13});
+	dispatcher.dispatch();
+	check(received == received_type{{1, 13}}, "dispatching clears the coalescing keys");
+
+	// A custom merge function combines the pending and the new event
+	received.clear();
+	auto const add = [](position_event& pending, position_event&& event) { pending.x += event.x; };
+	dispatcher.enqueue_coalesced(2, position_event{2, 1}, add);
+	dispatcher.enqueue_coalesced(2, position_event{2, 2}, add);
+	dispatcher.enqueue_coalesced(2, position_event{2, 4}, add);
+	dispatcher.dispatch();
+	check(received == received_type{{2, 7}}, "a merge function combines coalesced events");
+
+	// Each key type has its own index, so an int key and a string key never match
+	received.clear();
+	dispatcher.enqueue_coalesced(1, position_event{1, 1});
+	dispatcher.enqueue_coalesced(std::string{"1"}, position_event{1, 2});
+	dispatcher.enqueue_coalesced(std::string{"1"}, position_event{1, 3});
+	dispatcher.dispatch();
+	check(received == received_type{{1, 1}, {1, 3}}, "different key types are coalesced separately");
+
+	// Clearing the queue discards the keys along with the events
+	if constexpr (requires { dispatcher.clear(); }) {
+		received.clear();
+		dispatcher.enqueue_coalesced(5, position_event{5, 1});
+		dispatcher.clear();
+		dispatcher.enqueue_coalesced(5, position_event{5, 2});
+		dispatcher.dispatch();
+		check(received == received_type{{5, 2}}, "clear discards the coalescing keys");
+	}
+}
+
+template<typename DispatcherT>
+auto check_coalescing_during_dispatch(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto received = received_type{};
+
+	// Events coalesced during a dispatch must not merge into the events being dispatched
+	dispatcher.template connect<position_event>([&](position_event const& event) {
+		received.emplace_back(event.entity, event.x);
+		if (event.x < 100) {
+			dispatcher.enqueue_coalesced(event.entity, position_event{event.entity, event.x + 100});
+			dispatcher.enqueue_coalesced(event.entity, position_event{event.entity, event.x + 200});
+		}
+	});
+
+	dispatcher.enqueue_coalesced(1, position_event{1, 1});
+	dispatcher.dispatch();
+	check(received == received_type{{1, 1}}, "events coalesced during dispatch wait for the next one");
+
+	received.clear();
+	dispatcher.dispatch();
+	check(received == received_type{{1, 201}}, "events coalesced during dispatch are merged with each other");
+}
+
+auto check_channel() -> void {
+	std::cout << "event_channel\n";
+
+	auto dispatcher = events::event_dispatcher{};
+	auto received = received_type{};
+	connect_recording(dispatcher, received);
+
+	auto const channel = dispatcher.channel<position_event>();
+	channel.enqueue_coalesced(1, position_event{1, 1});
+	dispatcher.enqueue_coalesced(1, position_event{1, 2});
+	channel.enqueue_coalesced(1, position_event{1, 3});
+	check(channel.size() == 1, "a channel coalesces with its dispatcher's queue");
+
+	dispatcher.dispatch();
+	check(received == received_type{{1, 3}}, "a channel's coalesced events are dispatched");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_coalescing<events::event_dispatcher>("event_dispatcher");
+	check_coalescing<events::synchronized_event_dispatcher>("synchronized_event_dispatcher");
+	check_coalescing<events::static_event_dispatcher<position_event>>("static_event_dispatcher");
+
+	check_coalescing_during_dispatch<events::event_dispatcher>("event_dispatcher during dispatch");
+	check_coalescing_during_dispatch<events::synchronized_event_dispatcher>(
+		"synchronized_event_dispatcher during dispatch"
+	);
+
+	check_channel();
+
+	std::cout << "coalescing checks passed\n";
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include <events/detail/concurrent_dispatcher_table.hpp>
+
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <thread>
+
+#include "check.hpp"
+#include "counting_allocator.hpp"
+
+
+namespace {
+
+struct fake_dispatcher {
+	size_t id = 0;
+};
+
+using table_type = events::detail::concurrent_dispatcher_table<fake_dispatcher, counting_allocator<void>>;
+
+// IDs spread over several blocks of the table
+constexpr auto ids = std::array<size_t, 5>{0, 15, 16, 100, 1000};
+
+auto fill(table_type& table) -> void {
+	for (auto const id : ids) {
+		table.insert(id, std::make_shared<fake_dispatcher>(id));
+	}
+}
+
+auto finds_all(table_type const& table) -> bool {
+	for (auto const id : ids) {
+		auto const* const dispatcher = table.find(id);
+		if (!dispatcher || dispatcher->id != id) {
+			return false;
+		}
+	}
+	return true;
+}
+
+auto finds_none(table_type const& table) -> bool {
+	for (auto const id : ids) {
+		if (table.find(id)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+auto check_moves() -> void {
+	std::cout << "moves\n";
+	{
+		auto source = table_type{counting_allocator<void>{}};
+		fill(source);
+
+		auto target = table_type{std::move(source)};
+		check(finds_all(target) && target.size() == ids.size(), "a moved-to table finds every dispatcher");
+		check(finds_none(source) && source.size() == 0, "a moved-from table finds nothing");  //NOLINT(*-use-after-move)
+
+		// The moved-from table keeps its blocks, and is usable again
+		source.insert(16, std::make_shared<fake_dispatcher>(16));
+		check(source.find(16) && !source.find(0), "a moved-from table can be inserted into");
+
+		auto assigned = table_type{counting_allocator<void>{}};
+		assigned.insert(5, std::make_shared<fake_dispatcher>(5));
+		assigned = std::move(target);
+		check(finds_all(assigned) && !assigned.find(5), "assignment replaces the table's dispatchers");
+		check(finds_none(target), "a table moved by assignment finds nothing");  //NOLINT(*-use-after-move)
+
+		auto extended = table_type{std::move(assigned), counting_allocator<void>{}};
+		check(finds_all(extended), "an allocator-extended move finds every dispatcher");
+	}
+	check(live_allocations.load() == 0, "every block is freed with its table");
+}
+
+// A lookup may run on a table while it's moved from. It must never read freed memory, and anything it finds must
+// still be alive in the table it was moved to. This is meant to be run under ThreadSanitizer or AddressSanitizer.
+auto check_find_during_move() -> void {
+	std::cout << "find during move\n";
+
+	for (int round = 0; round < 200; ++round) {
+		auto source = table_type{counting_allocator<void>{}};
+		fill(source);
+
+		auto started = std::atomic<bool>{false};
+		auto stop = std::atomic<bool>{false};
+		auto valid = std::atomic<bool>{true};
+
+		auto target = std::optional<table_type>{};
+		{
+			auto reader = std::jthread{[&] {
+				started.store(true, std::memory_order_release);
+				while (!stop.load(std::memory_order_acquire)) {
+					for (auto const id : ids) {
+						if (auto const* const dispatcher = source.find(id); dispatcher && dispatcher->id != id) {
+							valid.store(false, std::memory_order_relaxed);
+						}
+					}
+				}
+			}};
+
+			while (!started.load(std::memory_order_acquire)) {
+				std::this_thread::yield();
+			}
+
+			// Alternate with the allocator-extended move, which copies the index into a new set of blocks
+			if (round % 2 == 0) {
+				target.emplace(std::move(source));
+			}
+			else {
+				target.emplace(std::move(source), counting_allocator<void>{});
+			}
+			stop.store(true, std::memory_order_release);
+		}
+
+		check(valid.load(), "a lookup during a move finds either nothing or the right dispatcher");
+		check(finds_all(*target), "the moved-to table finds every dispatcher");
+	}
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_moves();
+	check_find_during_move();
+
+	std::cout << "concurrent_dispatcher_table checks passed\n";
+	return 0;
+}
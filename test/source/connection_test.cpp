@@ -0,0 +1,125 @@
+#include <events/signal_handler/signal_handler.hpp>
+#include <events/signal_handler/synchronized_signal_handler.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+template<typename HandlerT>
+auto sorted_results(HandlerT& handler) -> std::vector<int> {
+	auto results = handler.publish();
+	std::ranges::sort(results);
+	return results;
+}
+
+// A stale connection, whether disconnected through a copy, by disconnect_all, or by a move of the handler, must never
+// disconnect a callback that was connected afterwards and may have reused the same slot.
+template<typename HandlerT>
+auto check_stale_connections(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto handler = HandlerT{};
+
+	auto first = handler.connect([] { return 1; });
+	auto const first_copy = first;
+	handler.connect([] { return 2; });
+
+	first.disconnect();
+	check(!first, "a disconnected connection is empty");
+	check(sorted_results(handler) == std::vector{2}, "disconnecting removes the callback");
+
+	// The new callback may reuse the slot the first one was stored in
+	auto third = handler.connect([] { return 3; });
+	auto stale = first_copy;
+	stale.disconnect();
+	check(sorted_results(handler) == std::vector{2, 3}, "a copy of a disconnected connection does nothing");
+
+	handler.disconnect_all();
+	check(sorted_results(handler).empty(), "disconnect_all removes every callback");
+
+	handler.connect([] { return 4; });
+	handler.connect([] { return 5; });
+	third.disconnect();
+	check(sorted_results(handler) == std::vector{4, 5}, "a connection invalidated by disconnect_all does nothing");
+
+	// Churn the slots, then disconnect every stale connection again
+	auto stale_connections = std::vector<events::connection>{};
+	for (int i = 0; i < 8; ++i) {
+		auto connection = handler.connect([i] { return 10 + i; });
+		stale_connections.push_back(connection);
+		connection.disconnect();
+	}
+	auto last = handler.connect([] { return 6; });
+	for (auto& connection : stale_connections) {
+		connection.disconnect();
+	}
+	check(sorted_results(handler) == std::vector{4, 5, 6}, "stale connections never disconnect a reused slot");
+
+	last.disconnect();
+	check(sorted_results(handler) == std::vector{4, 5}, "a valid connection still disconnects after churn");
+
+	auto const& const_handler = handler;
+	check(const_handler.size() == 2, "size counts the connected callbacks of a const handler");
+}
+
+// Keys issued by a handler before it is assigned to must not match the callbacks it receives
+template<typename HandlerT>
+auto check_assignment(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto target = HandlerT{};
+	auto target_connection = target.connect([] { return 1; });
+
+	auto source = HandlerT{};
+	source.connect([] { return 2; });
+	auto source_connection = source.connect([] { return 3; });
+
+	target = source;
+	target_connection.disconnect();
+	check(sorted_results(target) == std::vector{2, 3}, "a connection from before copy assignment does nothing");
+
+	source_connection.disconnect();
+	check(sorted_results(target) == std::vector{2, 3}, "a copy's connections don't refer to the copied callbacks");
+	check(sorted_results(source) == std::vector{2}, "a connection still disconnects from its own handler");
+
+	auto moved_from = HandlerT{};
+	auto moved_connection = moved_from.connect([] { return 4; });
+	auto const moved_from_connection = moved_connection;
+
+	target = std::move(moved_from);
+	moved_connection.disconnect();
+	check(sorted_results(target) == std::vector{4}, "a connection invalidated by move assignment does nothing");
+
+	auto reused = moved_from_connection;
+	moved_from.connect([] { return 5; });  //NOLINT(bugprone-use-after-move)
+	reused.disconnect();
+	check(sorted_results(moved_from) == std::vector{5}, "a moved-from handler ignores its old connections");
+}
+
+template<typename StorageT>
+using handler_with = events::signal_handler<int(), std::allocator<void>, std::function<int()>, StorageT>;
+
+}  //namespace
+
+
+auto main() -> int {
+	check_stale_connections<handler_with<events::colony_storage>>("colony_storage");
+	check_stale_connections<handler_with<events::dense_storage>>("dense_storage");
+	check_stale_connections<handler_with<events::inline_storage<2>>>("inline_storage<2>");
+	check_stale_connections<handler_with<events::inline_storage<16>>>("inline_storage<16>");
+	check_stale_connections<events::synchronized_signal_handler<int()>>("synchronized_signal_handler");
+
+	check_assignment<handler_with<events::colony_storage>>("colony_storage assignment");
+	check_assignment<handler_with<events::dense_storage>>("dense_storage assignment");
+	check_assignment<handler_with<events::inline_storage<2>>>("inline_storage<2> assignment");
+	check_assignment<handler_with<events::inline_storage<16>>>("inline_storage<16> assignment");
+
+	std::cout << "connection checks passed\n";
+	return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+
+/// The number of allocations made by every counting_allocator that haven't been deallocated yet
+inline auto live_allocations = std::atomic<std::ptrdiff_t>{0};
+
+
+/// A std::allocator that counts its live allocations, to check that memory which should be reclaimed is
+template<typename T>
+struct counting_allocator {
+	using value_type = T;
+
+	counting_allocator() noexcept = default;
+
+	template<typename U>
+	counting_allocator(counting_allocator<U> const&) noexcept {
+	}
+
+	[[nodiscard]]
+	auto allocate(size_t count) -> T* {
+		auto* const result = std::allocator<T>{}.allocate(count);
+		live_allocations.fetch_add(1, std::memory_order_relaxed);
+		return result;
+	}
+
+	auto deallocate(T* pointer, size_t count) noexcept -> void {
+		live_allocations.fetch_sub(1, std::memory_order_relaxed);
+		std::allocator<T>{}.deallocate(pointer, count);
+	}
+
+	template<typename U>
+	auto operator==(counting_allocator<U> const&) const noexcept -> bool {
+		return true;
+	}
+};
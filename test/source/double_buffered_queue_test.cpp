@@ -0,0 +1,89 @@
+#include <events/dispatcher/event_dispatcher.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <type_traits>
+
+#include "check.hpp"
+
+
+namespace {
+
+struct counted_event {
+	static inline size_t live = 0;
+
+	counted_event() noexcept {
+		++live;
+	}
+	counted_event(counted_event const&) noexcept {
+		++live;
+	}
+	counted_event(counted_event&&) noexcept {
+		++live;
+	}
+	~counted_event() {
+		--live;
+	}
+
+	auto operator=(counted_event const&) noexcept -> counted_event& = default;
+	auto operator=(counted_event&&) noexcept -> counted_event& = default;
+};
+
+// Only move constructible, so the queue can't compact its buffer in place
+struct counted_immovable_event {
+	static inline size_t live = 0;
+
+	counted_immovable_event() noexcept {
+		++live;
+	}
+	counted_immovable_event(counted_immovable_event&&) noexcept {
+		++live;
+	}
+	~counted_immovable_event() {
+		--live;
+	}
+
+	auto operator=(counted_immovable_event&&) -> counted_immovable_event& = delete;
+};
+
+// A sustained backlog dispatched in part every round must destroy the events it dispatched
+template<typename EventT>
+auto check_partial_dispatch_releases_events() -> void {
+	auto dispatcher = events::event_dispatcher{};
+	auto received = size_t{0};
+
+	dispatcher.connect<EventT>([&](EventT const&) { ++received; });
+
+	for (size_t round = 0; round < 1000; ++round) {
+		for (size_t i = 0; i < 10; ++i) {
+			dispatcher.enqueue<EventT>();
+		}
+		check(dispatcher.dispatch_n(5) == 5, "dispatch_n dispatches up to its budget");
+	}
+
+	check(received == 5000, "every dispatched event reaches the listener");
+	check(dispatcher.queue_size<EventT>() == 5000, "undispatched events stay queued");
+	if constexpr (std::is_nothrow_move_assignable_v<EventT>) {
+		check(EventT::live == 5000, "only undispatched events are alive");
+	}
+	else {
+		// Events that can't be moved in place are compacted by the next dispatch, so one round's worth may linger
+		check(EventT::live == 5005, "dispatched events don't accumulate across rounds");
+	}
+
+	dispatcher.dispatch();
+
+	check(received == 10000, "a full dispatch drains the backlog");
+	check(EventT::live == 0, "a full dispatch destroys every event");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_partial_dispatch_releases_events<counted_event>();
+	check_partial_dispatch_releases_events<counted_immovable_event>();
+
+	std::cout << "double_buffered_queue checks passed\n";
+	return 0;
+}
@@ -0,0 +1,93 @@
+#include <events/detail/epoch_readers.hpp>
+#include <events/signal_handler/snapshot_signal_handler.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "counting_allocator.hpp"
+
+
+namespace {
+
+auto check_phases() -> void {
+	using events::detail::epoch_readers;
+
+	auto readers = epoch_readers{};
+
+	check(readers.idle_phases() == epoch_readers::all_phases, "both phases are idle without readers");
+
+	{
+		auto const guard = epoch_readers::read_guard{readers};
+
+		// The reader is in one phase, so only the other is idle, however many times the epoch flips
+		auto const idle = readers.idle_phases();
+		check(idle != 0 && idle != epoch_readers::all_phases, "an active reader keeps its phase busy");
+		check(readers.idle_phases() == idle, "flipping the epoch doesn't release a reader");
+	}
+
+	check(readers.idle_phases() == epoch_readers::all_phases, "a phase is idle once its reader leaves");
+}
+
+// Publishers read snapshots while a writer keeps replacing them. Every replaced snapshot must be reclaimed.
+auto check_snapshot_reclamation() -> void {
+	using handler_type = events::snapshot_signal_handler<void(), counting_allocator<void>>;
+
+	{
+		auto handler = handler_type{};
+		auto calls = std::atomic<size_t>{0};
+		auto stop = std::atomic<bool>{false};
+
+		handler.connect([&] { calls.fetch_add(1, std::memory_order_relaxed); });
+
+		auto publishers = std::vector<std::jthread>{};
+		for (size_t i = 0; i < 4; ++i) {
+			publishers.emplace_back([&] {
+				while (!stop.load(std::memory_order_relaxed)) {
+					handler.publish();
+				}
+			});
+		}
+
+		for (size_t i = 0; i < 2000; ++i) {
+			auto connection = handler.connect([] {});
+			connection.disconnect();
+		}
+
+		stop.store(true, std::memory_order_relaxed);
+		publishers.clear();
+
+		check(calls.load() > 0, "publishers invoked the permanent callback");
+
+		// Once publishers are gone, replacing the snapshot reclaims everything retired before it
+		auto cycle = [&] {
+			auto connection = handler.connect([] {});
+			connection.disconnect();
+		};
+
+		cycle();
+		cycle();
+		auto const steady = live_allocations.load();
+
+		for (size_t i = 0; i < 1000; ++i) {
+			cycle();
+		}
+		check(live_allocations.load() == steady, "replaced snapshots don't accumulate");
+	}
+
+	check(live_allocations.load() == 0, "destroying the handler frees every snapshot");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_phases();
+	check_snapshot_reclamation();
+
+	std::cout << "epoch_readers checks passed\n";
+	return 0;
+}
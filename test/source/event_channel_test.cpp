@@ -0,0 +1,118 @@
+#include <events/dispatcher/event_dispatcher.hpp>
+#include <events/dispatcher/static_event_dispatcher.hpp>
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+struct value_event {
+	int value = 0;
+};
+
+struct other_event {
+	int value = 0;
+};
+
+template<typename DispatcherT>
+auto check_channel(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto total = 0;
+	auto other_total = 0;
+
+	// A channel can be obtained before anything is connected to its event type
+	auto const channel = dispatcher.template channel<value_event>();
+	dispatcher.template connect<value_event>([&total](value_event const& event) { total += event.value; });
+	dispatcher.template connect<other_event>([&other_total](other_event const& event) { other_total += event.value; });
+
+	channel.enqueue(2);
+	channel.enqueue(value_event{3});
+	channel.enqueue(std::vector{value_event{4}, value_event{5}});
+	check(channel.size() == 4, "a channel counts its enqueued events");
+	check(dispatcher.template queue_size<value_event>() == 4, "channel events are queued in the dispatcher");
+	check(total == 0, "enqueued events are not sent before dispatch");
+
+	dispatcher.dispatch();
+	check(total == 14, "the dispatcher dispatches events enqueued through a channel");
+	check(other_total == 0, "a channel only carries its own event type");
+	check(channel.size() == 0, "dispatching empties the channel");
+
+	channel.send(value_event{10});
+	channel.send(std::vector{value_event{20}, value_event{30}});
+	check(total == 74, "sending through a channel invokes the listeners immediately");
+
+	auto const same = dispatcher.template channel<value_event>();
+	same.enqueue(1);
+	check(channel.size() == 1, "every channel of an event type shares its queue");
+}
+
+// Discrete dispatchers are never moved, so a channel stays valid when its event dispatcher is
+template<typename DispatcherT>
+auto check_channel_after_move(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto source = DispatcherT{};
+	auto total = 0;
+
+	auto const channel = source.template channel<value_event>();
+	source.template connect<value_event>([&total](value_event const& event) { total += event.value; });
+
+	auto target = std::move(source);
+	channel.enqueue(5);
+	target.dispatch();
+	check(total == 5, "a channel reaches the dispatcher its event dispatcher was moved to");
+}
+
+auto check_concurrent_producers() -> void {
+	std::cout << "synchronized_event_dispatcher with concurrent producers\n";
+
+	auto dispatcher = events::synchronized_event_dispatcher{};
+	auto total = std::atomic<int>{0};
+	dispatcher.connect<value_event>([&total](value_event const& event) { total += event.value; });
+
+	auto const channel = dispatcher.channel<value_event>();
+
+	auto producers = std::vector<std::jthread>{};
+	for (int i = 0; i < 4; ++i) {
+		producers.emplace_back([channel] {
+			for (int j = 0; j < 1000; ++j) {
+				channel.enqueue(1);
+			}
+		});
+	}
+
+	// Dispatch concurrently with the producers, then collect whatever is left once they finish
+	for (int i = 0; i < 100; ++i) {
+		dispatcher.dispatch();
+	}
+	producers.clear();
+	dispatcher.dispatch();
+
+	check(total == 4000, "every event enqueued concurrently through a channel is dispatched once");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_channel<events::event_dispatcher>("event_dispatcher");
+	check_channel<events::synchronized_event_dispatcher>("synchronized_event_dispatcher");
+	check_channel<events::static_event_dispatcher<value_event, other_event>>("static_event_dispatcher");
+
+	check_channel_after_move<events::event_dispatcher>("event_dispatcher after move");
+	check_channel_after_move<events::synchronized_event_dispatcher>("synchronized_event_dispatcher after move");
+
+	check_concurrent_producers();
+
+	std::cout << "event channel checks passed\n";
+	return 0;
+}
@@ -0,0 +1,178 @@
+#include <events/dispatcher/event_dispatcher.hpp>
+#include <events/dispatcher/static_event_dispatcher.hpp>
+#include <events/frame_arena.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+// An upstream resource that counts its allocations and the bytes currently allocated from it
+class counting_resource final : public std::pmr::memory_resource {
+public:
+	size_t allocations = 0;
+	size_t outstanding = 0;
+
+private:
+	auto do_allocate(size_t bytes, size_t alignment) -> void* override {
+		++allocations;
+		outstanding += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	auto do_deallocate(void* ptr, size_t bytes, size_t alignment) -> void override {
+		outstanding -= bytes;
+		std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+	}
+
+	[[nodiscard]]
+	auto do_is_equal(std::pmr::memory_resource const& other) const noexcept -> bool override {
+		return this == &other;
+	}
+};
+
+struct message_event {
+	std::pmr::string text;
+};
+
+auto long_text(int i) -> std::string {
+	return "message " + std::to_string(i) + " is long enough that it can't be stored in the small string buffer";
+}
+
+auto arena_text(events::frame_arena& arena, int i) -> std::pmr::string {
+	auto const text = long_text(i);
+	return std::pmr::string{text.begin(), text.end(), &arena};
+}
+
+auto check_bump_allocation() -> void {
+	auto upstream = counting_resource{};
+	auto arena = events::frame_arena{&upstream, 1024};
+
+	auto* const first = arena.allocate(100, 8);
+	auto* const second = arena.allocate(100, 8);
+	check(upstream.allocations == 1, "allocations are bumped out of one block");
+	check(static_cast<std::byte*>(second) >= static_cast<std::byte*>(first) + 100, "allocations don't overlap");
+
+	arena.deallocate(first, 100, 8);
+	check(upstream.outstanding != 0, "deallocating doesn't return memory upstream");
+
+	// An allocation larger than the block size gets a block of its own
+	static_cast<void>(arena.allocate(4000, 16));
+	check(upstream.allocations == 2, "a large allocation adds a block");
+	check(arena.capacity_bytes() == upstream.outstanding, "capacity_bytes reports the memory held");
+
+	arena.release();
+	check(upstream.outstanding == 0 && arena.capacity_bytes() == 0, "release returns every block upstream");
+}
+
+auto check_dispatch_frames() -> void {
+	auto upstream = counting_resource{};
+	auto arena = events::frame_arena{&upstream, 256};
+	auto dispatcher = events::event_dispatcher{arena};
+
+	auto received = std::vector<std::string>{};
+	auto generation = 0;
+
+	// Every message enqueues a follow-up during dispatch. Its memory comes from the frame being dispatched, and must
+	// stay valid until the next dispatch sends it.
+	dispatcher.connect<message_event>([&](message_event const& event) {
+		received.emplace_back(event.text);
+		dispatcher.enqueue(message_event{arena_text(arena, ++generation)});
+	});
+
+	for (int i = 0; i < 4; ++i) {
+		dispatcher.enqueue(message_event{arena_text(arena, -i)});
+	}
+	dispatcher.dispatch();
+	check(received.size() == 4 && received[3] == long_text(-3), "events allocated before dispatch are intact");
+
+	// After a few frames the arena has merged its blocks, and steady traffic stops allocating upstream
+	auto allocations = size_t{0};
+	for (int frame = 0; frame < 20; ++frame) {
+		if (frame == 10) {
+			allocations = upstream.allocations;
+		}
+
+		received.clear();
+		auto const first_expected = generation - 3;
+		dispatcher.dispatch();
+
+		check(received.size() == 4, "every follow-up event is dispatched");
+		for (int i = 0; i < 4; ++i) {
+			check(received[static_cast<size_t>(i)] == long_text(first_expected + i), "events outlive their frame");
+		}
+	}
+	check(upstream.allocations == allocations, "steady traffic reuses the arena's memory");
+	check(dispatcher.queue_size() == 4, "the last follow-ups are still enqueued");
+}
+
+auto check_nested_dispatch() -> void {
+	auto upstream = counting_resource{};
+	auto arena = events::frame_arena{&upstream, 256};
+	auto dispatcher = events::event_dispatcher{arena};
+
+	auto kept = std::pmr::string{&arena};
+	auto nested = 0;
+
+	dispatcher.connect<message_event>([&](message_event const&) {
+		if (nested++ == 0) {
+			kept = arena_text(arena, 2);
+
+			// A nested dispatch must not start a new frame, or the second one would reuse the memory of kept
+			dispatcher.dispatch();
+			dispatcher.dispatch();
+
+			auto const overwrite = arena_text(arena, 3);
+			check(std::string_view{kept} == long_text(2), "memory from the current frame stays valid");
+		}
+	});
+
+	dispatcher.enqueue(message_event{arena_text(arena, 1)});
+	dispatcher.dispatch();
+	check(nested == 1, "nested dispatches don't resend the event being dispatched");
+}
+
+// A moved-from dispatcher no longer owns the arena, so dispatching it must not start frames
+template<typename DispatcherT>
+auto check_moved_from(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto upstream = counting_resource{};
+	auto arena = events::frame_arena{&upstream, 1024};
+	auto source = DispatcherT{arena};
+	auto target = std::move(source);
+
+	auto* const before = static_cast<std::byte*>(arena.allocate(64, 8));
+	source.dispatch();  //NOLINT(bugprone-use-after-move)
+	source.dispatch();
+	auto* const after = static_cast<std::byte*>(arena.allocate(64, 8));
+	check(after != before, "dispatching a moved-from dispatcher doesn't reset the arena");
+
+	target.dispatch();
+	target.dispatch();
+	auto* const reused = static_cast<std::byte*>(arena.allocate(64, 8));
+	check(reused == before, "the dispatcher moved to starts the arena's frames");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_bump_allocation();
+	check_dispatch_frames();
+	check_nested_dispatch();
+
+	check_moved_from<events::event_dispatcher>("event_dispatcher");
+	check_moved_from<events::static_event_dispatcher<message_event>>("static_event_dispatcher");
+
+	std::cout << "frame arena checks passed\n";
+	return 0;
+}
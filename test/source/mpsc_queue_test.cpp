@@ -0,0 +1,80 @@
+#include <events/detail/mpsc_queue.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "counting_allocator.hpp"
+
+
+namespace {
+
+constexpr size_t producer_count = 8;
+constexpr size_t events_per_producer = 20'000;
+
+struct tagged_event {
+	size_t producer;
+	size_t sequence;
+};
+
+// Producers enqueue concurrently with the consumer. Each producer's events must arrive once each, in order.
+auto check_producer_order() -> void {
+	{
+		auto queue = events::detail::mpsc_queue<tagged_event, counting_allocator<void>>{};
+		auto next_sequence = std::array<size_t, producer_count>{};
+		auto in_order = true;
+		auto done = std::atomic<size_t>{0};
+
+		auto const consume = [&] {
+			return queue.consume([&](tagged_event&& event) {
+				in_order = in_order && (event.sequence == next_sequence[event.producer]);
+				++next_sequence[event.producer];
+			});
+		};
+
+		auto received = size_t{0};
+		{
+			auto producers = std::vector<std::jthread>{};
+			for (size_t p = 0; p < producer_count; ++p) {
+				producers.emplace_back([&, p] {
+					for (size_t i = 0; i < events_per_producer; ++i) {
+						queue.emplace(tagged_event{p, i});
+					}
+					done.fetch_add(1, std::memory_order_release);
+				});
+			}
+
+			while (done.load(std::memory_order_acquire) != producer_count) {
+				received += consume();
+			}
+		}
+
+		received += consume();
+
+		check(in_order, "each producer's events are consumed in the order they were enqueued");
+		check(received == producer_count * events_per_producer, "every event is consumed exactly once");
+		check(queue.size() == 0, "the queue is empty once consumed");
+
+		// Without producers, the next consumes see every phase idle and free all consumed segments. What remains is
+		// the current segment and the retired list's buffer.
+		consume();
+		consume();
+		check(live_allocations.load() <= 2, "consumed segments are reclaimed");
+	}
+
+	check(live_allocations.load() == 0, "destroying the queue frees every segment");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_producer_order();
+
+	std::cout << "mpsc_queue checks passed\n";
+	return 0;
+}
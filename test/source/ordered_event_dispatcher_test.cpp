@@ -0,0 +1,166 @@
+#include <events/dispatcher/ordered_event_dispatcher.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+auto received = std::vector<std::string>{};
+
+struct small_event {
+	char value = 0;
+};
+
+struct alignas(alignof(std::max_align_t)) aligned_event {
+	std::uint64_t value = 0;
+};
+
+// An event that owns memory and counts its live instances, so relocation and destruction can be checked
+struct tracked_event {
+	static inline int live = 0;
+
+	explicit tracked_event(int v) : text(std::to_string(v) + " with enough text to defeat the small string buffer") {
+		++live;
+	}
+	tracked_event(tracked_event const& other) : text(other.text) {
+		++live;
+	}
+	tracked_event(tracked_event&& other) noexcept : text(std::move(other.text)) {
+		++live;
+	}
+
+	~tracked_event() {
+		--live;
+	}
+
+	auto operator=(tracked_event const&) -> tracked_event& = default;
+	auto operator=(tracked_event&&) noexcept -> tracked_event& = default;
+
+	std::string text;
+};
+
+auto connect_recording(events::ordered_event_dispatcher& dispatcher) -> void {
+	dispatcher.connect<small_event>([](small_event const& event) {
+		received.push_back("small " + std::to_string(event.value));
+	});
+	dispatcher.connect<aligned_event>([](aligned_event const& event) {
+		check(reinterpret_cast<std::uintptr_t>(&event) % alignof(aligned_event) == 0, "events are stored aligned");
+		received.push_back("aligned " + std::to_string(event.value));
+	});
+	dispatcher.connect<tracked_event>([](tracked_event const& event) {
+		received.push_back("tracked " + event.text.substr(0, event.text.find(' ')));
+	});
+}
+
+auto check_order() -> void {
+	auto dispatcher = events::ordered_event_dispatcher{};
+	connect_recording(dispatcher);
+
+	// Enough events of mixed sizes and alignments that the arena has to grow and relocate them several times
+	auto expected = std::vector<std::string>{};
+	for (int i = 0; i < 300; ++i) {
+		switch (i % 3) {
+			case 0:
+				dispatcher.enqueue(small_event{static_cast<char>(i % 100)});
+				expected.push_back("small " + std::to_string(i % 100));
+				break;
+			case 1:
+				dispatcher.enqueue(aligned_event{static_cast<std::uint64_t>(i)});
+				expected.push_back("aligned " + std::to_string(i));
+				break;
+			default:
+				dispatcher.enqueue<tracked_event>(i);
+				expected.push_back("tracked " + std::to_string(i));
+				break;
+		}
+	}
+
+	check(dispatcher.queue_size() == 300, "queue_size counts every enqueued event");
+	check(dispatcher.queue_size<tracked_event>() == 100, "queue_size counts one event type");
+	check(tracked_event::live == 100, "relocating the arena doesn't leak or double-destroy events");
+
+	received.clear();
+	dispatcher.dispatch();
+	check(received == expected, "events of every type are dispatched in exact enqueue order");
+	check(dispatcher.queue_size() == 0 && dispatcher.queue_size<tracked_event>() == 0, "dispatch empties the arena");
+	check(tracked_event::live == 0, "dispatched events are destroyed");
+}
+
+auto check_clear_and_send() -> void {
+	auto dispatcher = events::ordered_event_dispatcher{};
+	connect_recording(dispatcher);
+
+	dispatcher.enqueue<tracked_event>(1);
+	dispatcher.enqueue(small_event{2});
+	dispatcher.clear();
+	check(tracked_event::live == 0, "clear destroys the enqueued events");
+	check(dispatcher.queue_size() == 0, "clear empties the arena");
+
+	received.clear();
+	dispatcher.dispatch();
+	check(received.empty(), "cleared events are not dispatched");
+
+	dispatcher.send(small_event{3});
+	dispatcher.send<small_event>(std::vector{small_event{4}, small_event{5}});
+	check(received == std::vector<std::string>{"small 3", "small 4", "small 5"}, "send invokes listeners immediately");
+
+	dispatcher.enqueue<tracked_event>(6);
+}
+
+auto check_enqueue_during_dispatch() -> void {
+	auto dispatcher = events::ordered_event_dispatcher{};
+	auto count = 0;
+
+	// Every event enqueues another one, which must wait for the next dispatch
+	dispatcher.connect<small_event>([&dispatcher, &count](small_event const& event) {
+		++count;
+		if (event.value < 3) {
+			dispatcher.enqueue(small_event{static_cast<char>(event.value + 1)});
+		}
+	});
+
+	dispatcher.enqueue(small_event{0});
+	dispatcher.dispatch();
+	check(count == 1 && dispatcher.queue_size() == 1, "events enqueued during dispatch wait for the next one");
+
+	dispatcher.dispatch();
+	dispatcher.dispatch();
+	dispatcher.dispatch();
+	check(count == 4 && dispatcher.queue_size() == 0, "each dispatch sends the events enqueued before it");
+}
+
+auto check_move() -> void {
+	auto source = events::ordered_event_dispatcher{};
+	connect_recording(source);
+	source.enqueue(small_event{1});
+	source.enqueue<tracked_event>(2);
+
+	auto target = std::move(source);
+	check(target.queue_size() == 2, "moving keeps the enqueued events");
+
+	received.clear();
+	target.dispatch();
+	check(received == std::vector<std::string>{"small 1", "tracked 2"}, "moving keeps the listeners");
+	check(tracked_event::live == 0, "events moved with the dispatcher are destroyed once");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_order();
+	check_clear_and_send();
+	check(tracked_event::live == 0, "destroying the dispatcher destroys its enqueued events");
+	check_enqueue_during_dispatch();
+	check_move();
+
+	std::cout << "ordered event dispatcher checks passed\n";
+	return 0;
+}
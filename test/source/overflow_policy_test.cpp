@@ -0,0 +1,126 @@
+#include <events/dispatcher/event_dispatcher.hpp>
+#include <events/dispatcher/static_event_dispatcher.hpp>
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+struct tick_event {
+	int value = 0;
+};
+
+struct other_event {
+	int value = 0;
+};
+
+template<typename DispatcherT>
+auto connect_recording(DispatcherT& dispatcher, std::vector<int>& received) -> void {
+	dispatcher.template connect<tick_event>([&received](tick_event const& event) {
+		received.push_back(event.value);
+	});
+}
+
+template<typename DispatcherT>
+auto fill(DispatcherT& dispatcher, int count) -> int {
+	auto enqueued = 0;
+	for (int i = 0; i < count; ++i) {
+		if (dispatcher.enqueue(tick_event{i})) {
+			++enqueued;
+		}
+	}
+	return enqueued;
+}
+
+template<typename DispatcherT>
+auto check_policies(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto received = std::vector<int>{};
+	connect_recording(dispatcher, received);
+
+	dispatcher.template set_queue_capacity<tick_event>(3);
+	check(fill(dispatcher, 5) == 3, "drop_newest rejects events once the queue is full");
+	check(dispatcher.template dropped_count<tick_event>() == 2, "drop_newest counts the dropped events");
+	dispatcher.dispatch();
+	check(received == std::vector{0, 1, 2}, "drop_newest keeps the oldest events");
+
+	received.clear();
+	dispatcher.template set_queue_capacity<tick_event>(3, events::overflow_policy::drop_oldest);
+	check(fill(dispatcher, 5) == 5, "drop_oldest accepts every event");
+	check(dispatcher.template queue_size<tick_event>() == 3, "drop_oldest doesn't grow the queue");
+	dispatcher.dispatch();
+	check(received == std::vector{2, 3, 4}, "drop_oldest keeps the newest events in order");
+	check(dispatcher.template dropped_count<tick_event>() == 4, "drop_oldest counts the replaced events");
+
+	received.clear();
+	dispatcher.template set_queue_capacity<tick_event>(3, events::overflow_policy::overwrite_newest);
+	fill(dispatcher, 5);
+	dispatcher.dispatch();
+	check(received == std::vector{0, 1, 4}, "overwrite_newest replaces the last event");
+
+	received.clear();
+	dispatcher.template set_queue_capacity<tick_event>(3, events::overflow_policy::reject);
+	check(fill(dispatcher, 5) == 3, "reject refuses events once the queue is full");
+	check(dispatcher.template dropped_count<tick_event>() == 6, "rejected events aren't counted as dropped");
+	dispatcher.dispatch();
+	check(received == std::vector{0, 1, 2}, "reject keeps the oldest events");
+
+	// Other event types aren't affected by the capacity, and count towards the total
+	dispatcher.enqueue(other_event{});
+	dispatcher.enqueue(other_event{});
+	check(dispatcher.template queue_size<other_event>() == 2, "other event types are unbounded");
+	check(dispatcher.dropped_count() == 6, "the total dropped count sums every event type");
+	dispatcher.dispatch();
+
+	// Lowering the capacity keeps the events that are already pending
+	received.clear();
+	dispatcher.template set_queue_capacity<tick_event>(0);
+	fill(dispatcher, 5);
+	dispatcher.template set_queue_capacity<tick_event>(2);
+	check(!dispatcher.enqueue(tick_event{5}), "a queue over its new capacity is full");
+	dispatcher.dispatch();
+	check(received == std::vector{0, 1, 2, 3, 4}, "lowering the capacity keeps pending events");
+}
+
+template<typename DispatcherT>
+auto check_channel(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto dispatcher = DispatcherT{};
+	auto received = std::vector<int>{};
+	connect_recording(dispatcher, received);
+
+	dispatcher.template set_queue_capacity<tick_event>(2, events::overflow_policy::drop_oldest);
+	auto const channel = dispatcher.template channel<tick_event>();
+	check(channel.enqueue(tick_event{0}) && channel.enqueue(tick_event{1}), "a channel enqueues below the capacity");
+	check(channel.enqueue(tick_event{2}), "a channel follows its queue's overflow policy");
+	check(channel.size() == 2, "a channel shares its dispatcher's capacity");
+
+	dispatcher.dispatch();
+	check(received == std::vector{1, 2}, "a channel's events are dropped like the dispatcher's");
+	check(dispatcher.template dropped_count<tick_event>() == 1, "a channel's dropped events are counted");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	using static_dispatcher = events::static_event_dispatcher<tick_event, other_event>;
+
+	check_policies<events::event_dispatcher>("event_dispatcher");
+	check_policies<events::synchronized_event_dispatcher>("synchronized_event_dispatcher");
+	check_policies<static_dispatcher>("static_event_dispatcher");
+
+	check_channel<events::event_dispatcher>("event_dispatcher channel");
+	check_channel<events::synchronized_event_dispatcher>("synchronized_event_dispatcher channel");
+	check_channel<static_dispatcher>("static_event_dispatcher channel");
+
+	std::cout << "overflow policy checks passed\n";
+	return 0;
+}
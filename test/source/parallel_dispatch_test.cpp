@@ -0,0 +1,148 @@
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+
+#include "check.hpp"
+
+
+namespace {
+
+template<int N>
+struct numbered_event {
+	int value = 0;
+};
+
+using first_event = numbered_event<0>;
+using second_event = numbered_event<1>;
+using third_event = numbered_event<2>;
+using independent_event = numbered_event<3>;
+
+// Declared dependencies hold in every round, and every event is dispatched once
+auto check_dependency_order() -> void {
+	auto pool = boost::asio::thread_pool{4};
+	auto dispatcher = events::synchronized_event_dispatcher{};
+
+	auto first_done = std::atomic<bool>{false};
+	auto second_done = std::atomic<bool>{false};
+	auto in_order = std::atomic<bool>{true};
+	auto received = std::atomic<size_t>{0};
+
+	dispatcher.connect<first_event>([&](first_event const&) {
+		first_done.store(true);
+		++received;
+	});
+	dispatcher.connect<second_event>([&](second_event const&) {
+		in_order = in_order && first_done.load();
+		second_done.store(true);
+		++received;
+	});
+	dispatcher.connect<third_event>([&](third_event const&) {
+		in_order = in_order && second_done.load();
+		++received;
+	});
+	dispatcher.connect<independent_event>([&](independent_event const&) { ++received; });
+
+	check(dispatcher.add_dispatch_dependency<second_event, first_event>(), "a dependency can be added");
+	check(dispatcher.add_dispatch_dependency<third_event, second_event>(), "a dependency chain can be added");
+	check(!dispatcher.add_dispatch_dependency<first_event, third_event>(), "a dependency cycle is rejected");
+	check(!dispatcher.add_dispatch_dependency<first_event, first_event>(), "an event type can't depend on itself");
+
+	for (size_t round = 0; round < 200; ++round) {
+		first_done = false;
+		second_done = false;
+
+		// Enqueued in reverse, so that any ordering comes from the dependencies
+		for (size_t i = 0; i < 10; ++i) {
+			dispatcher.enqueue<third_event>();
+			dispatcher.enqueue<independent_event>();
+			dispatcher.enqueue<second_event>();
+			dispatcher.enqueue<first_event>();
+		}
+
+		dispatcher.parallel_dispatch(pool);
+	}
+
+	check(in_order.load(), "dependent event types are dispatched after their dependencies");
+	check(received.load() == 200 * 40, "every event is dispatched once");
+	check(dispatcher.queue_size() == 0, "the queues are empty after a parallel dispatch");
+
+	pool.join();
+}
+
+// A parallel dispatch completes on the calling thread when nothing else runs the executor
+auto check_unrun_executor() -> void {
+	auto dispatcher = events::synchronized_event_dispatcher{};
+	auto received = 0;
+
+	dispatcher.connect<first_event>([&](first_event const& e) { received += e.value; });
+	dispatcher.connect<second_event>([&](second_event const& e) { received += e.value; });
+	dispatcher.connect<third_event>([&](third_event const& e) { received += e.value; });
+
+	dispatcher.enqueue<first_event>(1);
+	dispatcher.enqueue<second_event>(2);
+	dispatcher.enqueue<third_event>(3);
+
+	auto context = boost::asio::io_context{};
+	dispatcher.parallel_dispatch(context);
+
+	check(received == 6, "an executor that isn't run doesn't block the dispatch");
+
+	// Also from inside the only thread of a pool
+	auto pool = boost::asio::thread_pool{1};
+	auto done = std::promise<void>{};
+
+	dispatcher.enqueue<first_event>(1);
+	dispatcher.enqueue<second_event>(2);
+	dispatcher.enqueue<third_event>(3);
+
+	boost::asio::post(pool, [&] {
+		dispatcher.parallel_dispatch(pool);
+		done.set_value();
+	});
+	done.get_future().wait();
+
+	check(received == 12, "a dispatch from the executor's only thread completes");
+
+	pool.join();
+}
+
+// The first exception is rethrown after the other event types finish
+auto check_exception() -> void {
+	auto pool = boost::asio::thread_pool{2};
+	auto dispatcher = events::synchronized_event_dispatcher{};
+
+	dispatcher.connect<first_event>([](first_event const&) { throw std::runtime_error{"listener failed"}; });
+	dispatcher.enqueue<first_event>();
+
+	auto threw = false;
+	try {
+		dispatcher.parallel_dispatch(pool.get_executor());
+	}
+	catch (std::runtime_error const&) {
+		threw = true;
+	}
+
+	check(threw, "an exception from a listener reaches the caller");
+
+	pool.join();
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_dependency_order();
+	check_unrun_executor();
+	check_exception();
+
+	std::cout << "parallel_dispatch checks passed\n";
+	return 0;
+}
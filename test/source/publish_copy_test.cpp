@@ -0,0 +1,98 @@
+#include <events/signal_handler/signal_handler.hpp>
+#include <events/signal_handler/snapshot_signal_handler.hpp>
+#include <events/signal_handler/synchronized_signal_handler.hpp>
+#include <events/small_function.hpp>
+
+#include <array>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+// A payload that counts how many times it is copied
+struct big {
+	static inline int copies = 0;
+
+	big() = default;
+	big(big const& other) : data(other.data) {
+		++copies;
+	}
+	big(big&&) noexcept = default;
+
+	~big() = default;
+
+	auto operator=(big const& other) -> big& {
+		data = other.data;
+		++copies;
+		return *this;
+	}
+	auto operator=(big&&) noexcept -> big& = default;
+
+	std::array<int, 64> data = {};
+};
+
+template<typename HandlerT>
+auto check_copies(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto handler = HandlerT{};
+	auto received = 0;
+
+	for (int i = 0; i < 4; ++i) {
+		handler.connect([&received](big const& payload) { received += payload.data[0]; });
+	}
+
+	auto payload = big{};
+	payload.data[0] = 1;
+
+	big::copies = 0;
+	handler.publish(payload);
+	check(received == 4, "every listener receives the payload");
+	check(big::copies == 0, "publishing to listeners that take a const reference doesn't copy the payload");
+
+	big::copies = 0;
+	handler.publish(big{});
+	check(big::copies == 0, "publishing a temporary doesn't copy the payload");
+
+	auto const batch = std::vector<std::tuple<big>>(3);
+	big::copies = 0;
+	handler.publish_batch(batch);
+	check(big::copies == 0, "publishing a batch doesn't copy any payload");
+
+	// A listener that takes the payload by value gets its own copy, but only that one
+	handler.connect([](big copy) { static_cast<void>(copy); });
+
+	big::copies = 0;
+	handler.publish(payload);
+	check(big::copies == 1, "a listener taking the payload by value copies it exactly once");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	using small_callback = events::small_function<void(big), 64>;
+	using dense_handler = events::signal_handler<
+		void(big), std::allocator<void>, std::function<void(big)>, events::dense_storage
+	>;
+
+	check_copies<events::signal_handler<void(big)>>("signal_handler");
+	check_copies<events::signal_handler<void(big), std::allocator<void>, small_callback>>(
+		"signal_handler with small_function"
+	);
+	check_copies<dense_handler>("signal_handler with dense_storage");
+	check_copies<events::synchronized_signal_handler<void(big)>>("synchronized_signal_handler");
+	check_copies<events::synchronized_signal_handler<void(big), std::allocator<void>, small_callback>>(
+		"synchronized_signal_handler with small_function"
+	);
+	check_copies<events::snapshot_signal_handler<void(big)>>("snapshot_signal_handler");
+
+	std::cout << "publish copy checks passed\n";
+	return 0;
+}
@@ -0,0 +1,172 @@
+#include <events/signal_handler/signal_handler.hpp>
+#include <events/signal_handler/snapshot_signal_handler.hpp>
+#include <events/signal_handler/synchronized_signal_handler.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+template<typename HandlerT>
+auto check_reduce_and_until(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto handler = HandlerT{};
+	auto invocations = 0;
+
+	check(handler.publish_reduce(7, std::plus<>{}, 1) == 7, "reducing with no callbacks returns the initial value");
+	check(!handler.publish_until([](int) { return true; }, 1), "no callback means no match");
+
+	for (int i = 1; i <= 5; ++i) {
+		handler.connect([i, &invocations](int n) {
+			++invocations;
+			return n * i;
+		});
+	}
+
+	invocations = 0;
+	check(handler.publish_reduce(0, std::plus<>{}, 2) == 30, "publish_reduce sums every result");
+	check(invocations == 5, "publish_reduce invokes every callback once");
+
+	// The fold must combine results in publish order, which a non-commutative operation shows
+	auto const order = handler.publish(1);
+	auto expected = std::string{};
+	for (auto const result : order) {
+		expected += std::to_string(result);
+	}
+	auto const concatenated = handler.publish_reduce(
+		std::string{}, [](std::string value, int result) { return std::move(value) + std::to_string(result); }, 1
+	);
+	check(concatenated == expected, "publish_reduce folds in publish order");
+
+	// Stop at the first result over 6, and don't invoke any callback after it
+	auto const predicate = [](int result) { return result > 6; };
+	auto const results = handler.publish(2);
+	auto const match = std::ranges::find_if(results, predicate);
+
+	invocations = 0;
+	auto const first = handler.publish_until(predicate, 2);
+	check(first.has_value() && *first == *match, "publish_until returns the first matching result");
+	check(invocations == static_cast<int>(match - results.begin()) + 1, "publish_until stops at the first match");
+
+	invocations = 0;
+	check(!handler.publish_until([](int result) { return result > 100; }, 2), "no matching result gives nullopt");
+	check(invocations == 5, "publish_until without a match invokes every callback");
+}
+
+template<typename HandlerT>
+auto check_publish_into(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto handler = HandlerT{};
+	auto invocations = 0;
+
+	for (int i = 1; i <= 4; ++i) {
+		handler.connect([i, &invocations](int n) {
+			++invocations;
+			return n * i;
+		});
+	}
+
+	auto expected = handler.publish(3);
+	std::ranges::sort(expected);
+
+	// A buffer with room to spare gets one result per callback at its front
+	auto buffer = std::vector<int>(6, -1);
+	auto const written = handler.publish_into(std::span{buffer}, 3);
+	check(written.data() == buffer.data() && written.size() == 4, "publish_into returns the written prefix");
+	check(buffer[4] == -1 && buffer[5] == -1, "publish_into doesn't write past the results");
+
+	auto sorted = std::vector<int>(written.begin(), written.end());
+	std::ranges::sort(sorted);
+	check(sorted == expected, "publish_into writes every result");
+
+	// A buffer that is too small is never overrun, but every callback still runs
+	auto small_buffer = std::vector<int>(6, -1);
+	invocations = 0;
+	auto const truncated = handler.publish_into(std::span{small_buffer}.first(2), 3);
+	check(truncated.size() == 2, "publish_into only writes as many results as fit");
+	check(small_buffer[2] == -1, "publish_into never writes past the end of the span");
+	check(invocations == 4, "publish_into invokes every callback even when results are discarded");
+
+	auto const none = handler.publish_into(std::span<int>{}, 3);
+	check(none.empty(), "publish_into with an empty span writes nothing");
+
+	auto appended = std::vector<int>{};
+	handler.publish_into(std::back_inserter(appended), 3);
+	std::ranges::sort(appended);
+	check(appended == expected, "publish_into an output iterator writes every result");
+}
+
+template<typename HandlerT>
+auto check_publish_batch(char const* name) -> void {
+	std::cout << name << '\n';
+
+	auto handler = HandlerT{};
+	auto calls = std::vector<std::pair<int, int>>{};
+
+	for (int id = 0; id < 3; ++id) {
+		handler.connect([id, &calls](int value) { calls.emplace_back(id, value); });
+	}
+
+	auto const empty = std::vector<std::tuple<int>>{};
+	handler.publish_batch(empty);
+	check(calls.empty(), "an empty batch invokes nothing");
+
+	auto const batch = std::vector<std::tuple<int>>{{10}, {20}, {30}, {40}};
+	handler.publish_batch(batch);
+	check(calls.size() == 12, "every callback is invoked once per argument set");
+
+	// Each callback runs over the whole batch, in order, before the next callback starts
+	for (size_t i = 0; i < calls.size(); ++i) {
+		check(calls[i].first == calls[i - (i % 4)].first, "callbacks are invoked callback-major");
+		check(calls[i].second == std::get<0>(batch[i % 4]), "each callback sees the batch in order");
+	}
+	check(calls[0].first != calls[4].first && calls[4].first != calls[8].first, "every callback gets its own run");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	using dense_handler = events::signal_handler<
+		int(int), std::allocator<void>, std::function<int(int)>, events::dense_storage
+	>;
+	using inline_handler = events::signal_handler<
+		int(int), std::allocator<void>, std::function<int(int)>, events::inline_storage<2>
+	>;
+
+	check_reduce_and_until<events::signal_handler<int(int)>>("signal_handler");
+	check_reduce_and_until<dense_handler>("signal_handler with dense_storage");
+	check_reduce_and_until<inline_handler>("signal_handler with inline_storage");
+	check_reduce_and_until<events::synchronized_signal_handler<int(int)>>("synchronized_signal_handler");
+	check_reduce_and_until<events::snapshot_signal_handler<int(int)>>("snapshot_signal_handler");
+
+	check_publish_into<events::signal_handler<int(int)>>("signal_handler");
+	check_publish_into<dense_handler>("signal_handler with dense_storage");
+	check_publish_into<inline_handler>("signal_handler with inline_storage");
+	check_publish_into<events::synchronized_signal_handler<int(int)>>("synchronized_signal_handler");
+	check_publish_into<events::snapshot_signal_handler<int(int)>>("snapshot_signal_handler");
+
+	using void_dense_handler = events::signal_handler<
+		void(int), std::allocator<void>, std::function<void(int)>, events::dense_storage
+	>;
+
+	check_publish_batch<events::signal_handler<void(int)>>("signal_handler");
+	check_publish_batch<void_dense_handler>("signal_handler with dense_storage");
+	check_publish_batch<events::synchronized_signal_handler<void(int)>>("synchronized_signal_handler");
+	check_publish_batch<events::snapshot_signal_handler<void(int)>>("snapshot_signal_handler");
+
+	std::cout << "publish checks passed\n";
+	return 0;
+}
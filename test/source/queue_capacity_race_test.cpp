@@ -0,0 +1,55 @@
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+#include "check.hpp"
+
+
+// Changes the capacity of a queue while it's dispatched with a shrink policy. The dispatching thread releases the
+// front buffer without the enqueue lock, so this is meant to be run under ThreadSanitizer.
+
+namespace {
+
+struct tick_event {
+	int value = 0;
+};
+
+}  //namespace
+
+
+auto main() -> int {
+	std::cout << "set_queue_capacity during dispatch\n";
+
+	auto dispatcher = events::synchronized_event_dispatcher{events::shrink_policy{2, 4}};
+	auto received = std::atomic<size_t>{0};
+
+	dispatcher.connect<tick_event>([&received](tick_event const&) {
+		received.fetch_add(1, std::memory_order_relaxed);
+	});
+
+	auto done = std::atomic<bool>{false};
+
+	auto producer = std::jthread{[&] {
+		for (int round = 0; round < 2000; ++round) {
+			dispatcher.set_queue_capacity<tick_event>(static_cast<size_t>(round % 3) * 16);
+			for (int i = 0; i < 8; ++i) {
+				dispatcher.enqueue(tick_event{i});
+			}
+		}
+		done.store(true, std::memory_order_release);
+	}};
+
+	while (!done.load(std::memory_order_acquire)) {
+		dispatcher.dispatch();
+	}
+	producer.join();
+	dispatcher.dispatch();
+
+	check(dispatcher.queue_size() == 0, "every event was dispatched");
+	check(received.load() + dispatcher.dropped_count() == 2000 * 8, "every event was dispatched or dropped");
+
+	std::cout << "queue capacity race checks passed\n";
+	return 0;
+}
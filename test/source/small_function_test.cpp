@@ -0,0 +1,178 @@
+#include <events/small_function.hpp>
+#include <events/signal_handler/signal_handler.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include "check.hpp"
+
+
+// Count every heap allocation made by the program, so the tests can tell whether a callable was stored inline
+namespace {
+size_t allocation_count = 0;
+}
+
+auto operator new(size_t size) -> void* {
+	++allocation_count;
+	if (auto* const ptr = std::malloc(size == 0 ? 1 : size)) {
+		return ptr;
+	}
+	throw std::bad_alloc{};
+}
+
+auto operator delete(void* ptr) noexcept -> void {
+	std::free(ptr);
+}
+
+auto operator delete(void* ptr, size_t) noexcept -> void {
+	std::free(ptr);
+}
+
+
+namespace {
+
+// Counts how many instances are alive, to check that a small_function destroys what it stores exactly once
+struct tracked {
+	static inline int alive = 0;
+
+	tracked() noexcept {
+		++alive;
+	}
+	tracked(tracked const&) noexcept {
+		++alive;
+	}
+	tracked(tracked&&) noexcept {
+		++alive;
+	}
+	~tracked() {
+		--alive;
+	}
+
+	auto operator=(tracked const&) -> tracked& = default;
+	auto operator=(tracked&&) -> tracked& = default;
+};
+
+auto twice(int n) -> int {
+	return n * 2;
+}
+
+auto check_inline_storage() -> void {
+	auto const a = 1, b = 2, c = 3;
+
+	auto const before = allocation_count;
+	auto func = events::small_function<int(int)>{[a, b, c](int n) { return n + a + b + c; }};
+	auto moved = std::move(func);
+
+	check(allocation_count == before, "a callable that fits in the buffer is stored without allocating");
+	check(moved(4) == 10, "an inline callable is invoked with the arguments");
+	check(!func, "a moved-from small_function is empty");
+}
+
+auto check_heap_fallback() -> void {
+	auto big = std::array<int, 64>{};
+	big.back() = 7;
+
+	auto const before = allocation_count;
+	auto func = events::small_function<int()>{[big] { return big.back(); }};
+
+	check(allocation_count == before + 1, "a callable larger than the buffer is allocated once");
+	check(func() == 7, "a heap-stored callable is invoked");
+
+	auto moved = std::move(func);
+	check(allocation_count == before + 1, "moving a heap-stored callable transfers the pointer");
+	check(moved() == 7, "a moved heap-stored callable still works");
+
+	// A bigger buffer holds the same callable inline
+	auto const wide_before = allocation_count;
+	auto wide = events::small_function<int(), sizeof(big) + sizeof(void*)>{[big] { return big.back(); }};
+	check(allocation_count == wide_before, "the buffer size is configurable");
+	check(wide() == 7, "a callable in a larger buffer is invoked");
+}
+
+auto check_lifetime() -> void {
+	{
+		auto func = events::small_function<void()>{[t = tracked{}] {}};
+		check(tracked::alive == 1, "an inline callable is stored once");
+
+		auto other = std::move(func);
+		check(tracked::alive == 1, "moving an inline callable destroys the moved-from copy");
+
+		other = nullptr;
+		check(tracked::alive == 0, "assigning nullptr destroys the callable");
+		check(!other, "a small_function assigned nullptr is empty");
+	}
+
+	{
+		auto big = std::array<std::byte, 256>{};
+		auto func = events::small_function<void()>{[t = tracked{}, big] { (void)big; }};
+		auto other = events::small_function<void()>{[t = tracked{}] {}};
+		check(tracked::alive == 2, "both callables are alive");
+
+		other = std::move(func);
+		check(tracked::alive == 1, "move assignment destroys the callable that was replaced");
+	}
+
+	check(tracked::alive == 0, "every stored callable is destroyed");
+}
+
+auto check_empty() -> void {
+	auto empty = events::small_function<void()>{};
+	check(!empty, "a default constructed small_function is empty");
+
+	auto threw = false;
+	try {
+		empty();
+	}
+	catch (std::bad_function_call const&) {
+		threw = true;
+	}
+	check(threw, "invoking an empty small_function throws std::bad_function_call");
+
+	auto const null = static_cast<int (*)(int)>(nullptr);
+	check(!events::small_function<int(int)>{null}, "a null function pointer makes an empty small_function");
+
+	auto const pointer = events::small_function<int(int)>{&twice};
+	check(pointer && pointer(21) == 42, "a function pointer is stored and invoked");
+}
+
+auto check_signal_handler() -> void {
+	using small_callback = events::small_function<void(int), 64>;
+	auto handler = events::signal_handler<void(int), std::allocator<void>, small_callback>{};
+
+	auto sum = 0;
+	auto const offset = 100;
+
+	auto connection = handler.connect([&sum](int n) { sum += n; });
+	handler.connect([&sum, offset](int n) { sum += n + offset; });
+
+	handler.publish(1);
+	check(sum == 102, "every small_function callback is invoked");
+
+	connection.disconnect();
+	handler.publish(1);
+	check(sum == 203, "a disconnected small_function callback isn't invoked");
+
+	// Signal handlers holding move-only callbacks can still be moved
+	auto moved = std::move(handler);
+	moved.publish(0);
+	check(sum == 303, "callbacks are kept when the signal handler is moved");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_inline_storage();
+	check_heap_fallback();
+	check_lifetime();
+	check_empty();
+	check_signal_handler();
+
+	std::cout << "small_function checks passed\n";
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include <events/dispatcher/static_event_dispatcher.hpp>
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+struct first_event {
+	int value = 0;
+};
+
+struct second_event {
+	std::string text;
+};
+
+struct third_event {
+	int value = 0;
+};
+
+auto received = std::vector<std::string>{};
+
+auto on_third(third_event const& event) -> void {
+	received.push_back("third " + std::to_string(event.value));
+}
+
+struct listener {
+	auto on_first(first_event const& event) -> void {
+		total += event.value;
+	}
+
+	int total = 0;
+};
+
+using dispatcher_type = events::static_event_dispatcher<first_event, second_event, third_event>;
+
+auto connect_logging(dispatcher_type& dispatcher) -> void {
+	dispatcher.connect<first_event>([](first_event const& event) {
+		received.push_back("first " + std::to_string(event.value));
+	});
+	dispatcher.connect<second_event>([](second_event const& event) { received.push_back("second " + event.text); });
+	dispatcher.connect<&on_third>();
+}
+
+auto check_dispatch_order() -> void {
+	auto dispatcher = dispatcher_type{};
+	connect_logging(dispatcher);
+
+	// Events are enqueued out of order, but dispatched one type at a time in the order the types are listed
+	dispatcher.enqueue(third_event{1});
+	dispatcher.enqueue<second_event>("a");
+	dispatcher.enqueue(first_event{2});
+	dispatcher.enqueue<first_event>(std::vector{first_event{3}, first_event{4}});
+
+	check(dispatcher.queue_size<first_event>() == 3, "queue_size counts one event type");
+	check(dispatcher.queue_size<second_event>() == 1, "queue_size counts each type separately");
+	check(dispatcher.queue_size() == 5, "queue_size without a type counts every event");
+
+	received.clear();
+	dispatcher.dispatch();
+	auto const expected = std::vector<std::string>{"first 2", "first 3", "first 4", "second a", "third 1"};
+	check(received == expected, "dispatch sends every event, one type at a time in listed order");
+	check(dispatcher.queue_size() == 0, "dispatch empties the queues");
+
+	received.clear();
+	dispatcher.send(third_event{5});
+	dispatcher.send<second_event>("b");
+	check(received == std::vector<std::string>{"third 5", "second b"}, "send invokes the listeners immediately");
+
+	dispatcher.enqueue(first_event{6});
+	dispatcher.enqueue(third_event{7});
+	dispatcher.clear();
+	received.clear();
+	dispatcher.dispatch();
+	check(received.empty(), "clear discards every enqueued event");
+}
+
+auto check_connections() -> void {
+	auto dispatcher = dispatcher_type{};
+	auto object = listener{};
+
+	auto connection = dispatcher.connect<&listener::on_first>(&object);
+	dispatcher.send(first_event{2});
+	check(object.total == 2, "a member function listener receives its event type");
+
+	dispatcher.send(third_event{1});
+	check(object.total == 2, "a listener only receives its own event type");
+
+	connection.disconnect();
+	dispatcher.send(first_event{2});
+	check(object.total == 2, "a disconnected listener receives nothing");
+}
+
+auto check_move() -> void {
+	auto source = dispatcher_type{};
+	connect_logging(source);
+	source.enqueue(first_event{1});
+	source.enqueue(third_event{2});
+
+	auto target = std::move(source);
+	check(target.queue_size() == 2, "moving keeps the enqueued events");
+
+	received.clear();
+	target.dispatch();
+	check(received == std::vector<std::string>{"first 1", "third 2"}, "moving keeps the listeners");
+
+	auto assigned = dispatcher_type{};
+	assigned.enqueue(second_event{"dropped"});
+	target.enqueue(first_event{3});
+	assigned = std::move(target);
+
+	received.clear();
+	assigned.dispatch();
+	check(received == std::vector<std::string>{"first 3"}, "move assignment replaces the listeners and events");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_dispatch_order();
+	check_connections();
+	check_move();
+
+	std::cout << "static_event_dispatcher checks passed\n";
+	return 0;
+}
@@ -0,0 +1,117 @@
+#include <events/signal_handler/static_signal.hpp>
+
+#include <array>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <vector>
+
+#include "check.hpp"
+
+
+namespace {
+
+auto calls = std::vector<int>{};
+
+auto record_double(int n) -> int {
+	calls.push_back(1);
+	return n * 2;
+}
+
+auto record_triple(int n) -> int {
+	calls.push_back(2);
+	return n * 3;
+}
+
+auto record_tenfold(int n) -> int {
+	calls.push_back(3);
+	return n * 10;
+}
+
+auto add_to(int& total, int n) -> void {
+	total += n;
+}
+
+using int_signal = events::static_signal<int(int), &record_double, &record_triple, &record_tenfold>;
+
+auto check_publish() -> void {
+	static_assert(int_signal::size() == 3);
+
+	calls.clear();
+	auto const results = int_signal::publish(5);
+	check(results == std::array{10, 15, 50}, "publish returns every result in listener order");
+	check(calls == std::vector{1, 2, 3}, "publish invokes the listeners in order");
+
+	// Reference arguments reach the listeners unchanged
+	using void_signal = events::static_signal<void(int&, int), &add_to, [](int& total, int n) { total *= n; }>;
+	auto total = 1;
+	void_signal::publish(total, 3);
+	check(total == 12, "a void signal invokes every listener in order");
+
+	using empty_signal = events::static_signal<int(int)>;
+	static_assert(empty_signal::size() == 0);
+	check(empty_signal::publish(1).empty(), "a signal without listeners returns no results");
+	check(empty_signal::publish_reduce(4, std::plus<>{}, 1) == 4, "reducing without listeners returns init");
+	check(empty_signal::publish_into(std::span<int>{}, 1).empty(), "publish_into without listeners writes nothing");
+}
+
+auto check_reduce_and_until() -> void {
+	calls.clear();
+	check(int_signal::publish_reduce(0, std::plus<>{}, 2) == 30, "publish_reduce folds every result");
+	check(calls.size() == 3, "publish_reduce invokes every listener");
+
+	calls.clear();
+	auto const first = int_signal::publish_until([](int result) { return result > 5; }, 2);
+	check(first == 6, "publish_until returns the first matching result");
+	check(calls == std::vector{1, 2}, "publish_until doesn't invoke listeners after the match");
+
+	calls.clear();
+	check(!int_signal::publish_until([](int result) { return result > 100; }, 2), "no match gives nullopt");
+	check(calls.size() == 3, "publish_until without a match invokes every listener");
+}
+
+auto check_publish_into() -> void {
+	auto buffer = std::array{-1, -1, -1, -1};
+	auto const written = int_signal::publish_into(std::span{buffer}, 1);
+	check(written.size() == 3 && written.data() == buffer.data(), "publish_into returns the written prefix");
+	check(buffer == std::array{2, 3, 10, -1}, "publish_into writes the results in listener order");
+
+	// A buffer that is too small is never overrun, but every listener still runs
+	buffer = std::array{-1, -1, -1, -1};
+	calls.clear();
+	auto const truncated = int_signal::publish_into(std::span{buffer}.first(2), 1);
+	check(truncated.size() == 2, "publish_into only writes as many results as fit");
+	check(buffer == std::array{2, 3, -1, -1}, "publish_into never writes past the end of the span");
+	check(calls.size() == 3, "publish_into invokes every listener even when results are discarded");
+
+	auto appended = std::vector<int>{};
+	int_signal::publish_into(std::back_inserter(appended), 1);
+	check(appended == std::vector{2, 3, 10}, "publish_into an output iterator writes every result");
+}
+
+auto check_publish_range() -> void {
+	calls.clear();
+	auto range = int_signal::publish_range(4);
+	check(calls.empty(), "publish_range doesn't invoke any listener until it is iterated");
+
+	auto results = std::vector<int>{};
+	for (auto const result : range) {
+		results.push_back(result);
+	}
+	check(results == std::vector{8, 12, 40}, "publish_range produces every result in listener order");
+	check(calls == std::vector{1, 2, 3}, "publish_range invokes each listener once");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_publish();
+	check_reduce_and_until();
+	check_publish_into();
+	check_publish_range();
+
+	std::cout << "static_signal checks passed\n";
+	return 0;
+}
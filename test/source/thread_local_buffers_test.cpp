@@ -0,0 +1,175 @@
+#include <events/detail/thread_local_buffers.hpp>
+#include <events/dispatcher/synchronized_event_dispatcher.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "check.hpp"
+#include "counting_allocator.hpp"
+
+
+namespace {
+
+constexpr size_t producer_count = 8;
+constexpr size_t events_per_producer = 20'000;
+
+struct tagged_event {
+	size_t producer;
+	size_t sequence;
+};
+
+// Producers append to their own buffers while the consumer collects them. Each producer's events must be collected
+// once each, in order, and the buffers of exited threads must be released once they're empty.
+auto check_producer_order() -> void {
+	{
+		auto buffers = events::detail::thread_local_buffers<tagged_event, counting_allocator<void>>{};
+		auto next_sequence = std::array<size_t, producer_count>{};
+		auto in_order = true;
+		auto done = std::atomic<size_t>{0};
+
+		auto const consume = [&] {
+			return buffers.consume([&](tagged_event&& event) {
+				in_order = in_order && (event.sequence == next_sequence[event.producer]);
+				++next_sequence[event.producer];
+			});
+		};
+
+		auto received = size_t{0};
+		{
+			auto producers = std::vector<std::jthread>{};
+			for (size_t p = 0; p < producer_count; ++p) {
+				producers.emplace_back([&, p] {
+					for (size_t i = 0; i < events_per_producer; ++i) {
+						buffers.emplace(tagged_event{p, i});
+					}
+					done.fetch_add(1, std::memory_order_release);
+				});
+			}
+
+			while (done.load(std::memory_order_acquire) != producer_count) {
+				received += consume();
+			}
+		}
+
+		received += consume();
+
+		check(in_order, "each thread's events are collected in the order they were enqueued");
+		check(received == producer_count * events_per_producer, "every event is collected exactly once");
+		check(buffers.size() == 0, "the buffers are empty once collected");
+
+		// Only the registry's own storage is left once the exited threads' buffers are unregistered
+		check(live_allocations.load() <= 1, "buffers of exited threads are released");
+	}
+
+	check(live_allocations.load() == 0, "destroying the buffers frees everything");
+}
+
+// A thread that outlives an instance must not keep using its buffer, even if a new instance reuses the address
+auto check_destroyed_instance() -> void {
+	auto producer_ready = std::atomic<int>{0};
+	auto step = std::atomic<int>{0};
+	auto received = size_t{0};
+
+	auto storage = std::optional<events::detail::thread_local_buffers<int>>{};
+	storage.emplace();
+
+	auto producer = std::jthread{[&] {
+		storage->emplace(1);
+		producer_ready.store(1, std::memory_order_release);
+
+		while (step.load(std::memory_order_acquire) != 1) {
+			std::this_thread::yield();
+		}
+
+		storage->emplace(2);
+		producer_ready.store(2, std::memory_order_release);
+	}};
+
+	while (producer_ready.load(std::memory_order_acquire) != 1) {
+		std::this_thread::yield();
+	}
+
+	storage.reset();
+	storage.emplace();
+	step.store(1, std::memory_order_release);
+
+	while (producer_ready.load(std::memory_order_acquire) != 2) {
+		std::this_thread::yield();
+	}
+
+	storage->consume([&](int&& value) {
+		check(value == 2, "events enqueued before an instance was destroyed don't reach its successor");
+		++received;
+	});
+
+	check(received == 1, "the successor instance collects the thread's new event");
+}
+
+// A buffer is allocated with the instance's allocator, and freed by its thread once the instance is destroyed
+auto check_buffer_allocation() -> void {
+	auto thread = std::jthread{[] {
+		auto const before = live_allocations.load();
+		auto buffers = std::optional<events::detail::thread_local_buffers<int, counting_allocator<void>>>{};
+		buffers.emplace();
+
+		buffers->emplace(1);
+		check(live_allocations.load() - before == 3, "the buffer, its events and the registry use the allocator");
+
+		buffers.reset();
+		check(live_allocations.load() - before == 1, "the thread still holds its buffer after the instance is gone");
+
+		auto other = events::detail::thread_local_buffers<int, counting_allocator<void>>{};
+		other.emplace(2);
+		check(live_allocations.load() - before == 3, "the buffer of a destroyed instance is freed on registration");
+	}};
+}
+
+// Events enqueued with enqueue_local() reach listeners at the next dispatch, in order per thread
+auto check_dispatcher_enqueue_local() -> void {
+	auto dispatcher = events::synchronized_event_dispatcher{};
+	auto next_sequence = std::array<size_t, producer_count>{};
+	auto in_order = true;
+	auto received = size_t{0};
+
+	dispatcher.connect<tagged_event>([&](tagged_event const& event) {
+		in_order = in_order && (event.sequence == next_sequence[event.producer]);
+		++next_sequence[event.producer];
+		++received;
+	});
+
+	{
+		auto producers = std::vector<std::jthread>{};
+		for (size_t p = 0; p < producer_count; ++p) {
+			producers.emplace_back([&, p] {
+				for (size_t i = 0; i < 1000; ++i) {
+					dispatcher.enqueue_local<tagged_event>(p, i);
+				}
+			});
+		}
+	}
+
+	check(dispatcher.queue_size<tagged_event>() == producer_count * 1000, "locally enqueued events are counted");
+
+	dispatcher.dispatch();
+
+	check(in_order, "each thread's events are dispatched in order");
+	check(received == producer_count * 1000, "every locally enqueued event is dispatched");
+}
+
+}  //namespace
+
+
+auto main() -> int {
+	check_producer_order();
+	check_destroyed_instance();
+	check_buffer_allocation();
+	check_dispatcher_enqueue_local();
+
+	std::cout << "thread_local_buffers checks passed\n";
+	return 0;
+}